@@ -0,0 +1 @@
+g++ examples/gpuculling/main.cpp -o main -std=c++20 -Iinclude -lGLEW -lglfw -lGL -pthread -O3
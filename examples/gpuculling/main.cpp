@@ -0,0 +1,116 @@
+// You can use this to effectively include everything
+#include <SimpleRenderer/sr.h>
+
+#include <cmath>
+#include <vector>
+
+// Initializing static variables - will include this in different CPP file eventually but for now is neccessary
+int WindowInstance::WindowCount = 0;
+
+// Number of instances along each side of the grid
+const int GridSize = 200;
+
+// An interleaved vertex with a color
+struct ColorVertex {
+	glm::vec3 Position;
+	glm::u8vec4 Color;
+};
+
+// Position at location 0, color at location 1 as normalized bytes
+typedef VertexFormat<ColorVertex, SR_ATTRIBUTE(ColorVertex, Position, 0), SR_ATTRIBUTE_NORMALIZED(ColorVertex, Color, 1)> ColorFormat;
+
+int main() {
+	// Creating Window, GPU culling needs GL 4.3
+	// Title, width, height, OpenGl version major, OpenGL version minor
+	WindowInstance Window("GPU Culling", 1280, 720, 4, 3);
+
+	// Creating Camera
+	// Position, target, speed, sense, fov
+	CameraInstance Camera(glm::vec3(-10.0f, 15.0f, -10.0f), glm::vec3(1.0f, -0.5f, 1.0f), 0.5f, 0.1f, 60.0f);
+
+	// Creating Renderer
+	// Window, camera, minimun render range, maximum render range
+	RendererInstance Renderer(&Window, &Camera, 0.1f, 300.0f);
+
+	// Creating Shader
+	// Vertex shader path, fragment shader path
+	ShaderInstance Shader("examples/gpuculling/shaders/vert.glsl", "examples/gpuculling/shaders/frag.glsl");
+
+	// Creating the culling, the shader reads the instance index from location 15
+	GPUCullingInstance Culling;
+	if(!GPUCullingInstance::IsSupported()) {
+		return 1;
+	}
+
+	// Cube, colored by corner
+	ColorVertex CubeVertices[8];
+	for(int Corner = 0; Corner < 8; Corner++) {
+		glm::vec3 Position((Corner & 1) ? 0.5f : -0.5f, (Corner & 2) ? 0.5f : -0.5f, (Corner & 4) ? 0.5f : -0.5f);
+		CubeVertices[Corner].Position = Position;
+		CubeVertices[Corner].Color = glm::u8vec4((Position.x + 0.5f) * 255.0f, (Position.y + 0.5f) * 255.0f, (Position.z + 0.5f) * 255.0f, 255.0f);
+	}
+	unsigned int CubeIndices[36] {
+		0, 1, 3, 3, 2, 0,  4, 5, 7, 7, 6, 4,  0, 4, 6, 6, 2, 0,
+		1, 5, 7, 7, 3, 1,  2, 3, 7, 7, 6, 2,  0, 1, 5, 5, 4, 0
+	};
+
+	// Pyramid, white at the top
+	ColorVertex PyramidVertices[5] {
+		{ glm::vec3(-0.5f, -0.5f, -0.5f), glm::u8vec4(255, 0, 0, 255) },
+		{ glm::vec3( 0.5f, -0.5f, -0.5f), glm::u8vec4(0, 255, 0, 255) },
+		{ glm::vec3( 0.5f, -0.5f,  0.5f), glm::u8vec4(0, 0, 255, 255) },
+		{ glm::vec3(-0.5f, -0.5f,  0.5f), glm::u8vec4(255, 255, 0, 255) },
+		{ glm::vec3( 0.0f,  0.5f,  0.0f), glm::u8vec4(255, 255, 255, 255) }
+	};
+	unsigned int PyramidIndices[18] {
+		0, 1, 2, 2, 3, 0,  0, 1, 4,  1, 2, 4,  2, 3, 4,  3, 0, 4
+	};
+
+	// Adding the meshes, the objects are only needed until they are copied
+	int Meshes[2];
+	{
+		ObjectInstance Cube(&Shader, glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f));
+		Cube.CreateVAO<ColorFormat>(CubeVertices, 8, CubeIndices, 36);
+		Meshes[0] = Culling.AddMesh(&Cube);
+
+		ObjectInstance Pyramid(&Shader, glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f));
+		Pyramid.CreateVAO<ColorFormat>(PyramidVertices, 5, PyramidIndices, 18);
+		Meshes[1] = Culling.AddMesh(&Pyramid);
+	}
+
+	// Adding a grid of instances, alternating meshes
+	for(int Index = 0; Index < GridSize * GridSize; Index++) {
+		glm::vec3 Position((float)(Index % GridSize) * 2.0f, 0.0f, (float)(Index / GridSize) * 2.0f);
+		Culling.AddInstance(Meshes[Index % 2], glm::translate(glm::mat4(1.0f), Position));
+	}
+
+	// Printing what everything costs on the GPU
+	MemoryTrackerInstance::Get().Dump();
+
+	// Main loop
+	int Frame = 0;
+	while(!Window.ShouldWindowClose()) {
+		// Starting frame
+		Renderer.StartFrame();
+
+		// Bobbing the first row, only these transforms get uploaded
+		for(int Index = 0; Index < GridSize; Index++) {
+			glm::vec3 Position((float)Index * 2.0f, std::sin(Frame * 0.05f + Index * 0.3f), 0.0f);
+			Culling.SetTransform(Index, glm::translate(glm::mat4(1.0f), Position));
+		}
+
+		// Culling and drawing everything without the CPU looking at a single instance
+		Renderer.RenderGPUCulled(&Culling, &Shader);
+
+		// Printing how many survived now and then, this waits on the GPU
+		if(Frame % 120 == 0) {
+			std::cout << Culling.ReadVisibleCount() << " of " << Culling.GetInstanceCount() << " instances visible\n";
+		}
+
+		// Ending frame
+		Renderer.FinishFrame();
+		Frame++;
+
+	}
+
+}
@@ -0,0 +1,18 @@
+#version 430 core
+
+layout(location = 0) in vec3 pPosition;
+layout(location = 1) in vec4 pColor;
+layout(location = 15) in uint iInstance;
+
+// Model matrices of every instance, filled by GPUCullingInstance
+layout(std430, binding = 0) readonly buffer SRTransforms { mat4 uTransforms[]; };
+
+uniform mat4 uView;
+uniform mat4 uPerspective;
+
+out vec4 vColor;
+
+void main() {
+	vColor = pColor;
+	gl_Position = uPerspective * uView * uTransforms[iInstance] * vec4(pPosition, 1.0);
+}
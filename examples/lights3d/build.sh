@@ -0,0 +1 @@
+g++ examples/lights3d/main.cpp -o main -std=c++20 -Iinclude -lGLEW -lglfw -lGL -pthread -O3
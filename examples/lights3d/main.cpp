@@ -0,0 +1,107 @@
+// You can use this to effectively include everything
+#include <SimpleRenderer/sr.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Initializing static variables - will include this in different CPP file eventually but for now is neccessary
+int WindowInstance::WindowCount = 0;
+
+// Number of point lights
+const int LightCount = 2000;
+
+// Number of quads along each side of the floor
+const int FloorQuads = 128;
+
+// Returns a random float between Min and Max
+float Random(float Min, float Max) {
+	return Min + (Max - Min) * ((float)std::rand() / (float)RAND_MAX);
+}
+
+int main() {
+	// Creating Window
+	// Title, width, height, OpenGl version major, OpenGL version minor
+	WindowInstance Window("Lights", 1280, 720, 4, 1);
+
+	// Creating Camera
+	// Position, target, speed, sense, fov
+	CameraInstance Camera(glm::vec3(0.0f, 6.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 0.2f, 0.1f, 60.0f);
+
+	// Creating Renderer
+	// Window, camera, minimun render range, maximum render range
+	RendererInstance Renderer(&Window, &Camera, 0.1f, 200.0f);
+
+	// Creating the lighting, with the default grid and thread count, and giving it to the renderer
+	ClusteredLightingInstance Lighting;
+	Renderer.SetLighting(&Lighting);
+
+	// Creating Shader
+	// Vertex shader path, fragment shader path
+	ShaderInstance Shader("examples/lights3d/shaders/vert.glsl", "examples/lights3d/shaders/frag.glsl");
+
+	// Making a big floor out of lots of small quads
+	std::vector<glm::vec3> Vertices;
+	std::vector<unsigned int> Indices;
+	for(int Z = 0; Z <= FloorQuads; Z++) {
+		for(int X = 0; X <= FloorQuads; X++) {
+			Vertices.push_back(glm::vec3((float)X - FloorQuads / 2, 0.0f, (float)Z - FloorQuads / 2));
+		}
+	}
+	for(int Z = 0; Z < FloorQuads; Z++) {
+		for(int X = 0; X < FloorQuads; X++) {
+			unsigned int Corner = Z * (FloorQuads + 1) + X;
+			unsigned int Quad[6] = { Corner, Corner + 1, Corner + FloorQuads + 2, Corner + FloorQuads + 2, Corner + FloorQuads + 1, Corner };
+			Indices.insert(Indices.end(), Quad, Quad + 6);
+		}
+	}
+
+	// Creating Object
+	// Shader, Scale, rotation, positions
+	ObjectInstance Floor(&Shader, glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f));
+	Floor.CreateVAO(Vertices.data(), (int)Vertices.size(), Indices.data(), (int)Indices.size());
+
+	// Scattering the lights over the floor
+	std::vector<glm::vec3> Centers;
+	for(int Index = 0; Index < LightCount; Index++) {
+		PointLight Light;
+		Light.Radius = Random(2.0f, 5.0f);
+		Light.Color = glm::vec3(Random(0.2f, 1.0f), Random(0.2f, 1.0f), Random(0.2f, 1.0f));
+		Light.Intensity = 1.5f;
+		Lighting.AddLight(Light);
+
+		Centers.push_back(glm::vec3(Random(-60.0f, 60.0f), Random(0.5f, 1.5f), Random(-60.0f, 60.0f)));
+	}
+
+	double LastPrint = glfwGetTime();
+
+	// Main loop
+	while(!Window.ShouldWindowClose()) {
+		// Moving the lights in little circles
+		float Time = (float)glfwGetTime();
+		std::vector<PointLight>& Lights = Lighting.GetLights();
+		for(int Index = 0; Index < LightCount; Index++) {
+			float Angle = Time + Index;
+			Lights[Index].Position = Centers[Index] + glm::vec3(std::cos(Angle), 0.0f, std::sin(Angle)) * 2.0f;
+		}
+
+		// Starting frame, this bins the lights
+		Renderer.StartFrame();
+
+		// Rendering Object
+		Renderer.RenderObject(&Floor);
+
+		// Ending frame
+		Renderer.FinishFrame();
+
+		// Printing the frame times every couple seconds
+		if(glfwGetTime() - LastPrint > 2.0) {
+			FrameTimeStats Stats = Renderer.GetFrameTimeStats();
+			std::cout << LightCount << " lights, " << Lighting.GetIndexCount() << " cluster entries, "
+				<< "avg " << Stats.Average << " ms, p99 " << Stats.Percentile99 << " ms\n";
+			LastPrint = glfwGetTime();
+		}
+
+	}
+
+}
@@ -0,0 +1,46 @@
+#version 410 core
+
+in vec3 vViewPosition;
+in vec4 vClipPosition;
+
+// Filled in by ClusteredLightingInstance
+uniform samplerBuffer uClusterLights;
+uniform usamplerBuffer uClusterGrid;
+uniform usamplerBuffer uClusterIndices;
+uniform vec4 uClusterSize;
+uniform vec4 uClusterDepth;
+
+out vec4 FragColor;
+
+void main() {
+	// Flat normal from the screen space derivatives, facing the camera
+	vec3 Normal = normalize(cross(dFdx(vViewPosition), dFdy(vViewPosition)));
+	if(dot(Normal, -vViewPosition) < 0.0) {
+		Normal = -Normal;
+	}
+
+	// Finding the cluster, x and y from NDC, z from the exponential depth slices
+	ivec3 Size = ivec3(uClusterSize.xyz);
+	vec2 NDC = vClipPosition.xy / vClipPosition.w;
+	ivec2 Tile = clamp(ivec2((NDC * 0.5 + 0.5) * vec2(Size.xy)), ivec2(0), Size.xy - 1);
+	float Depth = -vViewPosition.z;
+	int Slice = clamp(int(log(Depth / uClusterDepth.x) / uClusterDepth.z * float(Size.z)), 0, Size.z - 1);
+	int Cluster = (Slice * Size.y + Tile.y) * Size.x + Tile.x;
+
+	// Walking only the lights in this cluster
+	uvec2 Range = texelFetch(uClusterGrid, Cluster).xy;
+	vec3 Color = vec3(0.02);
+	for(uint Index = 0u; Index < Range.y; Index++) {
+		int Light = int(texelFetch(uClusterIndices, int(Range.x + Index)).r);
+		vec4 PositionRadius = texelFetch(uClusterLights, Light * 2);
+		vec3 LightColor = texelFetch(uClusterLights, Light * 2 + 1).rgb;
+
+		vec3 ToLight = PositionRadius.xyz - vViewPosition;
+		float Distance = length(ToLight);
+		float Falloff = clamp(1.0 - Distance / PositionRadius.w, 0.0, 1.0);
+		Color += LightColor * max(dot(Normal, ToLight / Distance), 0.0) * Falloff * Falloff;
+	}
+
+	FragColor = vec4(Color, 1.0);
+	
+}
@@ -0,0 +1,17 @@
+#version 410 core
+
+layout(location = 0) in vec3 pPosition;
+
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat4 uPerspective;
+
+out vec3 vViewPosition;
+out vec4 vClipPosition;
+
+void main() {
+	vec4 ViewPosition = uView * uModel * vec4(pPosition, 1.0);
+	vViewPosition = ViewPosition.xyz;
+	vClipPosition = uPerspective * ViewPosition;
+	gl_Position = vClipPosition;
+}
@@ -0,0 +1,101 @@
+// You can use this to effectively include everything
+#include <SimpleRenderer/sr.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Initializing static variables - will include this in different CPP file eventually but for now is neccessary
+int WindowInstance::WindowCount = 0;
+
+// Number of frames written out
+const int VideoFrames = 120;
+
+// Number of cubes along each side of the grid
+const int GridSize = 10;
+
+// An interleaved vertex with a color
+struct CubeVertex {
+	glm::vec3 Position;
+	glm::u8vec4 Color;
+};
+
+// Position at location 0, color at location 1 as normalized bytes
+typedef VertexFormat<CubeVertex, SR_ATTRIBUTE(CubeVertex, Position, 0), SR_ATTRIBUTE_NORMALIZED(CubeVertex, Color, 1)> CubeFormat;
+
+int main(int argc, char** argv) {
+	// Usage: main [prefix], frames are written to prefix00000.png and on
+	std::string Prefix = argc > 1 ? argv[1] : "frame";
+
+	// Creating Window
+	// Title, width, height, OpenGl version major, OpenGL version minor
+	WindowInstance Window("Readback", 1280, 720, 4, 1);
+
+	// Creating Camera
+	// Position, target, speed, sense, fov
+	CameraInstance Camera(glm::vec3(-8.0f, 10.0f, -8.0f), glm::vec3(1.0f, -0.8f, 1.0f), 0.2f, 0.1f, 60.0f);
+
+	// Creating Renderer
+	// Window, camera, minimun render range, maximum render range
+	RendererInstance Renderer(&Window, &Camera, 0.1f, 200.0f);
+
+	// Creating Shader
+	// Vertex shader path, fragment shader path
+	ShaderInstance Shader("examples/readback/shaders/vert.glsl", "examples/readback/shaders/frag.glsl");
+
+	// Cube vertices, colored by corner, and indices
+	CubeVertex Vertices[8];
+	for(int Corner = 0; Corner < 8; Corner++) {
+		glm::vec3 Position((Corner & 1) ? 0.5f : -0.5f, (Corner & 2) ? 0.5f : -0.5f, (Corner & 4) ? 0.5f : -0.5f);
+		Vertices[Corner].Position = Position;
+		Vertices[Corner].Color = glm::u8vec4((Position.x + 0.5f) * 255.0f, (Position.y + 0.5f) * 255.0f, (Position.z + 0.5f) * 255.0f, 255.0f);
+	}
+	unsigned int Indices[36] {
+		0, 1, 3, 3, 2, 0,  4, 5, 7, 7, 6, 4,  0, 4, 6, 6, 2, 0,
+		1, 5, 7, 7, 3, 1,  2, 3, 7, 7, 6, 2,  0, 1, 5, 5, 4, 0
+	};
+
+	// Creating the cubes
+	std::vector<std::unique_ptr<ObjectInstance>> Cubes;
+	for(int Index = 0; Index < GridSize * GridSize; Index++) {
+		glm::vec3 Position((float)(Index % GridSize) * 2.0f, 0.0f, (float)(Index / GridSize) * 2.0f);
+		Cubes.push_back(std::make_unique<ObjectInstance>(&Shader, glm::vec3(1.0f), glm::vec3(0.0f), Position));
+		Cubes.back()->CreateVAO<CubeFormat>(Vertices, 8, Indices, 36);
+	}
+
+	// Reading frames back and writing them as PNGs on a worker thread
+	// Callback, use worker, ring size
+	ReadbackInstance Readback([&Prefix](const ReadbackFrame& Frame) {
+		char Name[16];
+		std::snprintf(Name, sizeof(Name), "%05llu.png", (unsigned long long)Frame.Frame);
+		WritePNG(Prefix + Name, Frame);
+	}, true, 4);
+	Renderer.SetReadback(&Readback);
+
+	// Main loop
+	int Frame = 0;
+	while(!Window.ShouldWindowClose() && Frame < VideoFrames) {
+		// Starting frame
+		Renderer.StartFrame();
+
+		// Spinning the cubes
+		for(int Index = 0; Index < GridSize * GridSize; Index++) {
+			glm::vec3 Position((float)(Index % GridSize) * 2.0f, 0.0f, (float)(Index / GridSize) * 2.0f);
+			Cubes[Index]->SetWorldData(glm::vec3(1.0f), glm::vec3(0.0f, Frame * 3.0f, 0.0f), Position);
+			Renderer.RenderObject(Cubes[Index].get());
+		}
+
+		// Ending frame
+		Renderer.FinishFrame();
+		Frame++;
+
+	}
+
+	// Writing out the frames still in flight
+	Renderer.SetReadback(nullptr);
+	Readback.Flush();
+
+	std::cout << Readback.GetDeliveredCount() << " frames written, " << Readback.GetSkippedCount() << " skipped\n";
+
+}
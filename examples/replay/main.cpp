@@ -0,0 +1,138 @@
+// You can use this to effectively include everything
+#include <SimpleRenderer/sr.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Initializing static variables - will include this in different CPP file eventually but for now is neccessary
+int WindowInstance::WindowCount = 0;
+
+// Number of frames recorded
+const int CaptureFrames = 300;
+
+// Number of cubes along each side of the grid
+const int GridSize = 20;
+
+// An interleaved vertex with a color
+struct CubeVertex {
+	glm::vec3 Position;
+	glm::u8vec4 Color;
+};
+
+// Position at location 0, color at location 1 as normalized bytes
+typedef VertexFormat<CubeVertex, SR_ATTRIBUTE(CubeVertex, Position, 0), SR_ATTRIBUTE_NORMALIZED(CubeVertex, Color, 1)> CubeFormat;
+
+// Renders a grid of spinning cubes and records it
+void Record(const char* Path) {
+	// Creating Window
+	// Title, width, height, OpenGl version major, OpenGL version minor
+	WindowInstance Window("Recording", 1280, 720, 4, 1);
+
+	// Creating Camera
+	// Position, target, speed, sense, fov
+	CameraInstance Camera(glm::vec3(-15.0f, 20.0f, -15.0f), glm::vec3(1.0f, -0.8f, 1.0f), 0.2f, 0.1f, 60.0f);
+
+	// Creating Renderer
+	// Window, camera, minimun render range, maximum render range
+	RendererInstance Renderer(&Window, &Camera, 0.1f, 200.0f);
+
+	// Creating Shader
+	// Vertex shader path, fragment shader path
+	ShaderInstance Shader("examples/replay/shaders/vert.glsl", "examples/replay/shaders/frag.glsl");
+
+	// Cube vertices, colored by corner, and indices
+	CubeVertex Vertices[8];
+	for(int Corner = 0; Corner < 8; Corner++) {
+		glm::vec3 Position((Corner & 1) ? 0.5f : -0.5f, (Corner & 2) ? 0.5f : -0.5f, (Corner & 4) ? 0.5f : -0.5f);
+		Vertices[Corner].Position = Position;
+		Vertices[Corner].Color = glm::u8vec4((Position.x + 0.5f) * 255.0f, (Position.y + 0.5f) * 255.0f, (Position.z + 0.5f) * 255.0f, 255.0f);
+	}
+	unsigned int Indices[36] {
+		0, 1, 3, 3, 2, 0,  4, 5, 7, 7, 6, 4,  0, 4, 6, 6, 2, 0,
+		1, 5, 7, 7, 3, 1,  2, 3, 7, 7, 6, 2,  0, 1, 5, 5, 4, 0
+	};
+
+	// Creating the cubes
+	std::vector<std::unique_ptr<ObjectInstance>> Cubes;
+	for(int Index = 0; Index < GridSize * GridSize; Index++) {
+		glm::vec3 Position((float)(Index % GridSize) * 2.0f, 0.0f, (float)(Index / GridSize) * 2.0f);
+		Cubes.push_back(std::make_unique<ObjectInstance>(&Shader, glm::vec3(1.0f), glm::vec3(0.0f), Position));
+		Cubes.back()->CreateVAO<CubeFormat>(Vertices, 8, Indices, 36);
+	}
+
+	// Recording the next frames
+	// Path, frame count
+	CaptureInstance Capture(Path, CaptureFrames);
+	Renderer.SetCapture(&Capture);
+
+	// Main loop, until the capture is done
+	int Frame = 0;
+	while(!Window.ShouldWindowClose() && Capture.IsRecording()) {
+		// Starting frame
+		Renderer.StartFrame();
+
+		// Spinning every other cube, so there are both static and moving objects in the capture
+		for(int Index = 0; Index < GridSize * GridSize; Index += 2) {
+			glm::vec3 Position((float)(Index % GridSize) * 2.0f, 0.0f, (float)(Index / GridSize) * 2.0f);
+			Cubes[Index]->SetWorldData(glm::vec3(1.0f), glm::vec3(0.0f, Frame * 2.0f, 0.0f), Position);
+		}
+
+		// Rendering the cubes
+		for(std::unique_ptr<ObjectInstance>& Cube : Cubes) {
+			Renderer.RenderObject(Cube.get());
+		}
+
+		// Ending frame
+		Renderer.FinishFrame();
+		Frame++;
+
+	}
+
+	std::cout << "Recorded " << Capture.GetRecordedFrames() << " frames to " << Path << "\n";
+
+}
+
+// Plays a capture back in a hidden window as fast as possible
+void Replay(const char* Path, int Loops) {
+	// Creating a hidden window just for the context, the replay draws offscreen at the captured size
+	// Title, width, height, OpenGl version major, OpenGL version minor, visible
+	WindowInstance Window("Replay", 64, 64, 4, 1, false);
+	Window.SetSwapInterval(0);
+
+	// Loading the capture, this uploads everything in it
+	ReplayInstance Replay(Path);
+	if(!Replay.IsLoaded()) {
+		return;
+	}
+
+	// Replaying and printing every frame time
+	std::vector<double> Times = Replay.Run(Loops);
+	double Total = 0.0;
+	for(int Index = 0; Index < (int)Times.size(); Index++) {
+		std::cout << "Frame " << Index << ": " << Times[Index] << " ms\n";
+		Total += Times[Index];
+	}
+
+	std::cout << Replay.GetFrameCount() << " frames, " << Loops << " loops, " << Total << " ms total, "
+		<< "avg " << Total / std::max((int)Times.size(), 1) << " ms\n";
+
+	// Times of an incomplete capture are not the times of the real frames
+	if(!Replay.IsComplete()) {
+		std::cout << "Capture is incomplete, these times leave out everything the capture did not record\n";
+	}
+
+}
+
+int main(int argc, char** argv) {
+	// Usage: main record [file] to make a capture, main [file] [loops] to replay one
+	if(argc > 1 && std::strcmp(argv[1], "record") == 0) {
+		Record(argc > 2 ? argv[2] : "capture.srcap");
+
+	} else {
+		Replay(argc > 1 ? argv[1] : "capture.srcap", argc > 2 ? std::stoi(argv[2]) : 1);
+
+	}
+
+}
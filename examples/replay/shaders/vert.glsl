@@ -0,0 +1,15 @@
+#version 410 core
+
+layout(location = 0) in vec3 pPosition;
+layout(location = 1) in vec4 pColor;
+
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat4 uPerspective;
+
+out vec4 vColor;
+
+void main() {
+	vColor = pColor;
+	gl_Position = uPerspective * uView * uModel * vec4(pPosition, 1.0);
+}
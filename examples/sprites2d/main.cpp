@@ -0,0 +1,125 @@
+// You can use this to effectively include everything
+#include <SimpleRenderer/sr.h>
+
+#include <cstdlib>
+#include <vector>
+
+// Initializing static variables - will include this in different CPP file eventually but for now is neccessary
+int WindowInstance::WindowCount = 0;
+
+// Number of sprites drawn every frame
+const int SpriteCount = 100000;
+
+// A single moving sprite
+struct Mover {
+	glm::vec2 Position;
+	glm::vec2 Velocity;
+	float Rotation;
+	float Spin;
+	int Layer;
+	glm::vec4 Color;
+};
+
+// Returns a random float between Min and Max
+float Random(float Min, float Max) {
+	return Min + (Max - Min) * ((float)std::rand() / (float)RAND_MAX);
+}
+
+int main() {
+	// Creating Window
+	// Title, width, height, OpenGl version major, OpenGL version minor
+	WindowInstance Window("Sprites", 1280, 720, 4, 1);
+
+	// No vsync, so the frame times show how long the frame actually takes
+	Window.SetSwapInterval(0);
+
+	// Creating Camera, the renderer needs one even though sprites dont use it
+	// Position, target, speed, sense, fov
+	CameraInstance Camera(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, 1.0f), 0.0f, 0.0f, 45.0f);
+
+	// Creating Renderer
+	// Window, camera, minimun render range, maximum render range
+	RendererInstance Renderer(&Window, &Camera, 0.1f, 100.0f);
+
+	// Creating Shader
+	// Vertex shader path, fragment shader path
+	ShaderInstance Shader("examples/sprites2d/shaders/vert.glsl", "examples/sprites2d/shaders/frag.glsl");
+
+	// Creating a texture array with 4 checkerboards made on the CPU
+	// Format, width, height, layer capacity
+	TextureArrayInstance Textures(TextureFormat::Uncompressed(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4), 32, 32, 4);
+	for(int Layer = 0; Layer < 4; Layer++) {
+		std::vector<unsigned char> Pixels(32 * 32 * 4);
+		for(int Y = 0; Y < 32; Y++) {
+			for(int X = 0; X < 32; X++) {
+				bool Light = ((X / (4 << Layer)) + (Y / (4 << Layer))) % 2 == 0;
+				unsigned char* Pixel = &Pixels[(Y * 32 + X) * 4];
+				Pixel[0] = Light ? 255 : 64;
+				Pixel[1] = Light ? 255 : 64;
+				Pixel[2] = Light ? 255 : 64;
+				Pixel[3] = 255;
+			}
+		}
+		Textures.AddLayer(TextureData::FromPixels(32, 32, Pixels.data()));
+	}
+	Textures.GenerateMipmaps();
+
+	// Creating the sprite batch, big enough for every sprite in one draw
+	// Shader, sprites per draw
+	SpriteBatchInstance Batch(&Shader, SpriteCount);
+
+	// Making the sprites
+	std::vector<Mover> Movers(SpriteCount);
+	for(Mover& Sprite : Movers) {
+		Sprite.Position = glm::vec2(Random(0.0f, 1280.0f), Random(0.0f, 720.0f));
+		Sprite.Velocity = glm::vec2(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f));
+		Sprite.Rotation = Random(0.0f, 360.0f);
+		Sprite.Spin = Random(-90.0f, 90.0f);
+		Sprite.Layer = std::rand() % 4;
+		Sprite.Color = glm::vec4(Random(0.3f, 1.0f), Random(0.3f, 1.0f), Random(0.3f, 1.0f), 1.0f);
+	}
+
+	double LastPrint = glfwGetTime();
+
+	// Main loop
+	while(!Window.ShouldWindowClose()) {
+		// Starting frame
+		Renderer.StartFrame();
+
+		// Moving and queueing the sprites
+		float DeltaTime = (float)(Window.GetFrameTimer()->GetLastFrameTime() / 1000.0);
+		float Width = (float)Window.GetWindowWidth();
+		float Height = (float)Window.GetWindowHeight();
+		for(Mover& Sprite : Movers) {
+			Sprite.Position = Sprite.Position + Sprite.Velocity * DeltaTime;
+			Sprite.Rotation += Sprite.Spin * DeltaTime;
+
+			// Bouncing off the edges
+			if(Sprite.Position.x < 0.0f || Sprite.Position.x > Width) {
+				Sprite.Velocity.x = -Sprite.Velocity.x;
+			}
+			if(Sprite.Position.y < 0.0f || Sprite.Position.y > Height) {
+				Sprite.Velocity.y = -Sprite.Velocity.y;
+			}
+
+			// Array, layer, position, size, rotation, color
+			Batch.Draw(&Textures, Sprite.Layer, Sprite.Position, glm::vec2(8.0f), Sprite.Rotation, Sprite.Color);
+		}
+
+		// Drawing every sprite
+		Renderer.RenderSpriteBatch(&Batch);
+
+		// Ending frame
+		Renderer.FinishFrame();
+
+		// Printing the frame times every couple seconds
+		if(glfwGetTime() - LastPrint > 2.0) {
+			FrameTimeStats Stats = Renderer.GetFrameTimeStats();
+			std::cout << SpriteCount << " sprites, " << Batch.GetDrawCallCount() << " draw calls, "
+				<< "avg " << Stats.Average << " ms, p50 " << Stats.Percentile50 << " ms, p99 " << Stats.Percentile99 << " ms\n";
+			LastPrint = glfwGetTime();
+		}
+
+	}
+
+}
@@ -0,0 +1,13 @@
+#version 410 core
+
+in vec3 vUV;
+in vec4 vColor;
+
+uniform sampler2DArray uSpriteTextures;
+
+out vec4 FragColor;
+
+void main() {
+	FragColor = texture(uSpriteTextures, vUV) * vColor;
+	
+}
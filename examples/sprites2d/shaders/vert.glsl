@@ -0,0 +1,17 @@
+#version 410 core
+
+layout(location = 0) in vec2 pPosition;
+layout(location = 1) in vec2 pUV;
+layout(location = 2) in float pLayer;
+layout(location = 3) in vec4 pColor;
+
+uniform mat4 uPerspective;
+
+out vec3 vUV;
+out vec4 vColor;
+
+void main() {
+	vUV = vec3(pUV, pLayer);
+	vColor = pColor;
+	gl_Position = uPerspective * vec4(pPosition, 0.0, 1.0);
+}
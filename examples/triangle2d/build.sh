@@ -1 +1 @@
-g++ examples/triangle2d/main.cpp -o main -std=c++20 -Iinclude -lGLEW -lglfw -lGL -O3
+g++ examples/triangle2d/main.cpp -o main -std=c++20 -Iinclude -lGLEW -lglfw -lGL -pthread -O3
@@ -0,0 +1,390 @@
+/**
+ * @file bake.h
+ * @brief Contains the static batch, which merges objects that never move into a few pre-transformed chunks.
+ * @note Every triangle is moved into world space once and put in the chunk of the grid cell its center is in. Each chunk is one draw with an identity model matrix, and chunks outside the view are skipped.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/camera.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/object.h>
+#include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/vertex.h>
+
+/**
+ * @class StaticBatchInstance
+ * @brief Bakes static objects sharing a shader and vertex layout into spatial chunks.
+ * @note Add objects, call Bake(), then draw it with RendererInstance.RenderStaticBatch(). The objects can be deleted after they are added.
+ * @note The vertex attribute at location 0 must be a vec3 position. Normals and tangents are transformed too if their locations are given, every other attribute is copied as it is.
+ * @warning Reads the objects' buffers back from the GPU, so adding stalls. Meant for load time.
+ */
+class StaticBatchInstance {
+public:
+	StaticBatchInstance() {}		// Default constructor
+
+	/**
+	 * @brief Constructor for the batch.
+	 * @param _Shader The shader every object in the batch uses.
+	 * @param _ChunkSize Size of the grid cells in world units. Smaller chunks cull better but draw more.
+	 * @param _NormalLocation Location of a vec3 normal, transformed by the inverse transpose of the model matrix. -1 if there is none.
+	 * @param _TangentLocation Location of a vec3 or vec4 tangent, transformed by the model matrix. The w of a vec4 is the handedness and flips for mirrored objects. -1 if there is none.
+	 */
+	StaticBatchInstance(ShaderInstance* _Shader, float _ChunkSize = 32.0f, int _NormalLocation = -1, int _TangentLocation = -1) : Shader(_Shader), ChunkSize(_ChunkSize > 0.0f ? _ChunkSize : 32.0f), NormalLocation(_NormalLocation), TangentLocation(_TangentLocation) {
+		// Setting the guard
+		HasShader = Shader != nullptr;
+
+	}
+
+	/**
+	 * @brief Adds an object, moving its triangles into world space and into chunks.
+	 * @param Object The object, which must use the batch's shader and have finished uploading.
+	 * @return Returns a bool of whether the object was added.
+	 */
+	bool Add(ObjectInstance* Object) {
+		// Guard checking
+		if(!HasShader || Baked) {
+			SR_LOG_ERROR("StaticBatchInstance: Add(): Batch has no shader or has already been baked.");
+			return false;
+
+		}
+		Object->Poll();
+		if(!Object->CanRender() || Object->GetShader() != Shader) {
+			SR_LOG_ERROR("StaticBatchInstance: Add(): Object cannot render or uses a different shader.");
+			return false;
+
+		}
+
+		// Taking the layout of the first object, the rest have to match
+		if(Layout.empty()) {
+			Layout.assign(Object->GetVertexLayout(), Object->GetVertexLayout() + Object->GetVertexLayoutCount());
+			Stride = Object->GetVertexStride();
+
+			// Finding the attributes that get transformed
+			PositionOffset = FindFloatAttribute(0, 3, 3);
+			NormalOffset = NormalLocation >= 0 ? FindFloatAttribute(NormalLocation, 3, 3) : -1;
+			TangentOffset = TangentLocation >= 0 ? FindFloatAttribute(TangentLocation, 3, 4) : -1;
+			TangentHasW = TangentOffset >= 0 && FindVertexAttribute(Layout.data(), (int)Layout.size(), TangentLocation)->Components == 4;
+
+			// Dropping a layout that cant be baked so the next object can set it instead
+			if(PositionOffset < 0) {
+				SR_LOG_ERROR("StaticBatchInstance: Add(): Vertex layout has no vec3 position at location 0.");
+				Layout.clear();
+				return false;
+
+			}
+			if((NormalLocation >= 0 && NormalOffset < 0) || (TangentLocation >= 0 && TangentOffset < 0)) {
+				SR_LOG_ERROR("StaticBatchInstance: Add(): Vertex layout has no float vec3 normal or tangent at the given location.");
+				Layout.clear();
+				return false;
+
+			}
+
+		}
+		if(!Object->HasVertexLayout(Layout.data(), (int)Layout.size(), Stride)) {
+			SR_LOG_ERROR("StaticBatchInstance: Add(): Object has a different vertex layout than the rest of the batch.");
+			return false;
+
+		}
+
+		// Reading the buffers back
+		std::vector<char> Vertices;
+		std::vector<char> IndexBytes;
+		GetContentFromBuffer(Object->GetVertexBuffer(), Vertices);
+		GetContentFromBuffer(Object->GetIndexBuffer(), IndexBytes);
+
+		int VerticesCount = (int)(Vertices.size() / Stride);
+		int IndicesCount = std::min(Object->GetIndicesCount(), (int)(IndexBytes.size() / sizeof(unsigned int)));
+		const unsigned int* Indices = (const unsigned int*)IndexBytes.data();
+
+		// Normals need the inverse transpose so non uniform scales dont skew them
+		glm::mat4 Model = glm::make_mat4(Object->GetModelMatrix());
+		glm::mat3 Linear = glm::mat3(Model);
+		glm::mat3 NormalMatrix = glm::transpose(glm::inverse(Linear));
+		bool Mirrored = glm::determinant(Linear) < 0.0f;
+
+		// Moving the vertices into world space
+		for(int Index = 0; Index < VerticesCount; Index++) {
+			char* Vertex = Vertices.data() + (std::size_t)Index * Stride;
+			glm::vec3 Local;
+			std::memcpy(&Local, Vertex + PositionOffset, sizeof(glm::vec3));
+			glm::vec4 World = Model * glm::vec4(Local, 1.0f);
+			glm::vec3 Moved(World.x, World.y, World.z);
+			std::memcpy(Vertex + PositionOffset, &Moved, sizeof(glm::vec3));
+
+			if(NormalOffset >= 0) {
+				TransformDirection(Vertex + NormalOffset, NormalMatrix);
+
+			}
+
+			if(TangentOffset >= 0) {
+				TransformDirection(Vertex + TangentOffset, Linear);
+
+				// Mirroring flips which way the bitangent points
+				if(TangentHasW && Mirrored) {
+					float Handedness;
+					std::memcpy(&Handedness, Vertex + TangentOffset + sizeof(glm::vec3), sizeof(float));
+					Handedness = -Handedness;
+					std::memcpy(Vertex + TangentOffset + sizeof(glm::vec3), &Handedness, sizeof(float));
+
+				}
+
+			}
+
+		}
+
+		// Putting every triangle in the chunk its center is in
+		std::unordered_map<std::size_t, std::unordered_map<unsigned int, unsigned int>> Remaps;	// Chunk, then object vertex to chunk vertex
+		for(int Triangle = 0; Triangle + 2 < IndicesCount; Triangle += 3) {
+			// Skipping triangles pointing outside the buffer
+			if(Indices[Triangle] >= (unsigned int)VerticesCount || Indices[Triangle + 1] >= (unsigned int)VerticesCount || Indices[Triangle + 2] >= (unsigned int)VerticesCount) {
+				continue;
+
+			}
+
+			glm::vec3 Corners[3];
+			for(int Corner = 0; Corner < 3; Corner++) {
+				std::memcpy(&Corners[Corner], Vertices.data() + (std::size_t)Indices[Triangle + Corner] * Stride + PositionOffset, sizeof(glm::vec3));
+
+			}
+			glm::vec3 Center = (Corners[0] + Corners[1] + Corners[2]) / 3.0f;
+
+			// Finding or making the chunk
+			std::size_t ChunkIndex = GetChunk(Center);
+			Chunk& Target = Chunks[ChunkIndex];
+			std::unordered_map<unsigned int, unsigned int>& Remap = Remaps[ChunkIndex];
+
+			// Copying the vertices over, once per chunk
+			for(int Corner = 0; Corner < 3; Corner++) {
+				unsigned int Source = Indices[Triangle + Corner];
+				auto Found = Remap.find(Source);
+				unsigned int Destination;
+				if(Found == Remap.end()) {
+					Destination = (unsigned int)(Target.Vertices.size() / Stride);
+					Target.Vertices.insert(Target.Vertices.end(), Vertices.data() + (std::size_t)Source * Stride, Vertices.data() + (std::size_t)(Source + 1) * Stride);
+					Remap[Source] = Destination;
+
+				} else {
+					Destination = Found->second;
+
+				}
+				Target.Indices.push_back(Destination);
+
+				// Growing the bounds
+				Target.Min = glm::min(Target.Min, Corners[Corner]);
+				Target.Max = glm::max(Target.Max, Corners[Corner]);
+
+			}
+
+		}
+
+		ObjectCount++;
+		return true;
+
+	}
+
+	/**
+	 * @brief Uploads every chunk. Nothing can be added after this.
+	 * @note The CPU copies are freed.
+	 */
+	void Bake() {
+		if(Baked) {
+			return;
+
+		}
+
+		for(Chunk& Current : Chunks) {
+			// Identity world data, the vertices are already in world space
+			Current.Object = std::make_unique<ObjectInstance>(Shader, glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f));
+			Current.Object->CreateVAO(Current.Vertices.data(), (int)(Current.Vertices.size() / Stride), Stride, Layout.data(), (int)Layout.size(), Current.Indices.data(), (int)Current.Indices.size());
+
+			// Freeing the copies
+			Current.Vertices = std::vector<char>();
+			Current.Indices = std::vector<unsigned int>();
+
+		}
+
+		ChunkLookup.clear();
+		Baked = true;
+
+	}
+
+	/**
+	 * @brief Finds the chunks inside the view. Called by RendererInstance.RenderStaticBatch().
+	 * @param ViewProjection The perspective matrix times the view matrix.
+	 * @return Returns the objects of the visible chunks, valid until the next call.
+	 */
+	const std::vector<ObjectInstance*>& Cull(const glm::mat4& ViewProjection) {
+		Visible.clear();
+		if(!Baked) {
+			return Visible;
+
+		}
+
+		// Getting the frustum planes out of the matrix
+		glm::vec4 Planes[6];
+		GetFrustumPlanes(ViewProjection, Planes);
+
+		// Testing the corner of each box furthest along each plane
+		for(Chunk& Current : Chunks) {
+			bool Inside = true;
+			for(const glm::vec4& Plane : Planes) {
+				glm::vec3 Furthest(Plane.x >= 0.0f ? Current.Max.x : Current.Min.x, Plane.y >= 0.0f ? Current.Max.y : Current.Min.y, Plane.z >= 0.0f ? Current.Max.z : Current.Min.z);
+				if(Plane.x * Furthest.x + Plane.y * Furthest.y + Plane.z * Furthest.z + Plane.w < 0.0f) {
+					Inside = false;
+					break;
+
+				}
+
+			}
+
+			if(Inside) {
+				Visible.push_back(Current.Object.get());
+
+			}
+
+		}
+
+		return Visible;
+
+	}
+
+	/**
+	 * @brief Function to check if the batch has been baked.
+	 * @return Returns a bool of whether Bake() has been called.
+	 */
+	bool IsBaked() {
+		return Baked;
+
+	}
+
+	/**
+	 * @brief Function to get the number of objects added.
+	 * @return Returns the object count.
+	 */
+	int GetObjectCount() {
+		return ObjectCount;
+
+	}
+
+	/**
+	 * @brief Function to get the number of chunks, i.e the most draws the batch does.
+	 * @return Returns the chunk count.
+	 */
+	int GetChunkCount() {
+		return (int)Chunks.size();
+
+	}
+
+	/**
+	 * @brief Function to get the number of chunks that passed the last Cull().
+	 * @return Returns the visible chunk count.
+	 */
+	int GetVisibleCount() {
+		return (int)Visible.size();
+
+	}
+
+private:
+	/**
+	 * @struct Chunk
+	 * @brief The triangles of a single grid cell.
+	 */
+	struct Chunk {
+		std::vector<char> Vertices;			// Interleaved vertices, freed when baked
+		std::vector<unsigned int> Indices;	// Indices into Vertices, freed when baked
+		glm::vec3 Min = glm::vec3(INFINITY);	// Bounds of the triangles, which can poke out of the cell
+		glm::vec3 Max = glm::vec3(-INFINITY);
+		std::unique_ptr<ObjectInstance> Object;	// The baked object
+
+	};
+
+	/**
+	 * @brief Finds a float attribute of the batch's layout.
+	 * @return Returns the offset of the attribute, or -1 if there isnt one at the location with a component count in range.
+	 */
+	int FindFloatAttribute(int Location, int MinComponents, int MaxComponents) {
+		const VertexAttributeLayout* Attribute = FindVertexAttribute(Layout.data(), (int)Layout.size(), (unsigned int)Location);
+		if(!Attribute || Attribute->Type != GL_FLOAT || Attribute->Integer || Attribute->Components < MinComponents || Attribute->Components > MaxComponents) {
+			return -1;
+
+		}
+
+		return (int)Attribute->Offset;
+
+	}
+
+	/**
+	 * @brief Transforms a vec3 direction in place and normalizes it.
+	 */
+	static void TransformDirection(char* Direction, const glm::mat3& Matrix) {
+		glm::vec3 Local;
+		std::memcpy(&Local, Direction, sizeof(glm::vec3));
+		glm::vec3 World = Matrix * Local;
+		float Length = glm::length(World);
+		if(Length > 0.0f) {
+			World /= Length;
+
+		}
+		std::memcpy(Direction, &World, sizeof(glm::vec3));
+
+	}
+
+	/**
+	 * @brief Gets the chunk of the cell a point is in, making it if needed.
+	 * @return Returns the index into Chunks.
+	 */
+	std::size_t GetChunk(glm::vec3 Point) {
+		// Packing the cell coordinates into a key, 21 bits each
+		std::uint64_t Key = 0;
+		for(int Axis = 0; Axis < 3; Axis++) {
+			std::int64_t Cell = (std::int64_t)std::floor(Point[Axis] / ChunkSize);
+			Key |= ((std::uint64_t)Cell & 0x1FFFFF) << (Axis * 21);
+
+		}
+
+		auto Found = ChunkLookup.find(Key);
+		if(Found != ChunkLookup.end()) {
+			return Found->second;
+
+		}
+
+		Chunks.emplace_back();
+		ChunkLookup[Key] = Chunks.size() - 1;
+		return Chunks.size() - 1;
+
+	}
+
+	ShaderInstance* Shader;				// Shader of every object in the batch
+	float ChunkSize = 32.0f;			// Size of the grid cells in world units
+	bool HasShader = false;				// Bool guard determining whether the batch has a shader
+	bool Baked = false;					// Bool guard determining whether the chunks have been uploaded
+	int ObjectCount = 0;				// Number of objects added
+
+	std::vector<VertexAttributeLayout> Layout;	// Vertex layout shared by every object, the chunk objects point into this
+	int Stride = 0;						// Size of a vertex in bytes
+	int PositionOffset = -1;			// Offset of the position in a vertex
+	int NormalLocation = -1;			// Location of the normal, -1 if there is none
+	int NormalOffset = -1;				// Offset of the normal in a vertex
+	int TangentLocation = -1;			// Location of the tangent, -1 if there is none
+	int TangentOffset = -1;				// Offset of the tangent in a vertex
+	bool TangentHasW = false;			// Whether the tangent is a vec4 with the handedness in w
+
+	std::vector<Chunk> Chunks;			// Every chunk
+	std::unordered_map<std::uint64_t, std::size_t> ChunkLookup;	// Cell key to index into Chunks, cleared when baked
+	std::vector<ObjectInstance*> Visible;	// Chunks that passed the last Cull
+
+};
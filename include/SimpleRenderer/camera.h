@@ -5,12 +5,38 @@
 
 #pragma once
 
+#include <cmath>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+/**
+ * @brief Gets the frustum planes out of a view projection matrix.
+ * @param ViewProjection The perspective matrix times the view matrix.
+ * @param Planes Array of 6 planes to fill, xyz is the normal pointing inwards and w the distance. Left, right, bottom, top, near, far.
+ * @note The planes are normalized, so a point's distance to them is in world units.
+ */
+inline void GetFrustumPlanes(const glm::mat4& ViewProjection, glm::vec4* Planes) {
+	// Each plane is the last row plus or minus one of the others
+	for(int Axis = 0; Axis < 3; Axis++) {
+		for(int Sign = 0; Sign < 2; Sign++) {
+			glm::vec4& Plane = Planes[Axis * 2 + Sign];
+			for(int Column = 0; Column < 4; Column++) {
+				float Row = ViewProjection[Column][Axis];
+				Plane[Column] = ViewProjection[Column][3] + (Sign == 0 ? Row : -Row);
+
+			}
+			Plane /= std::sqrt(Plane.x * Plane.x + Plane.y * Plane.y + Plane.z * Plane.z);
+
+		}
+
+	}
+
+}
+
 /**
  * @class CameraInstance
  * @brief Contains methods needed to get the view matrix.
@@ -0,0 +1,373 @@
+/**
+ * @file capture.h
+ * @brief Contains the frame capture, which records what the renderer does into a file that ReplayInstance can play back.
+ * @note A capture holds everything needed to draw the frames again: shader sources, vertex and index data, model matrices, camera matrices and draws. It does not need the application or its assets.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/object.h>
+#include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/vertex.h>
+
+/**
+ * @enum CaptureRecord
+ * @brief Type of a record in a capture file. Every record starts with one of these as a byte.
+ * @note Layout of the records after the type byte, in the byte order of the machine that made the capture. Vertex data is copied from the GPU as is, so it could not be converted anyway.
+ * @note Shader: uint32 id, uint32 vertex source length, vertex source, uint32 fragment source length, fragment source.
+ * @note Mesh: uint32 id, uint32 shader id, uint32 index count, uint32 stride, uint32 attribute count, the attributes, uint32 vertex bytes, vertices, indices as uint32s.
+ * @note Each attribute is uint32 location, uint32 components, uint32 type, uint8 normalized, uint8 integer, uint32 offset.
+ * @note Transform: uint32 mesh id, 16 floats model matrix.
+ * @note Frame: 16 floats view matrix, 16 floats perspective matrix.
+ * @note Draw: uint32 mesh id.
+ * @note Unsupported: uint32 name length, name of the renderer feature that was used but not recorded.
+ */
+enum class CaptureRecord : std::uint8_t {
+	End = 0,			// End of the file
+	Shader = 1,			// A shader program, first used in this frame
+	Mesh = 2,			// An object's buffers, first drawn in this frame
+	Transform = 3,		// A model matrix change
+	Frame = 4,			// Start of a frame, with the camera
+	Draw = 5,			// A RenderObject call
+	FrameEnd = 6,		// End of a frame
+	Unsupported = 7		// A renderer feature was used that the capture does not record, written once per feature
+
+};
+
+/**
+ * @struct CaptureHeader
+ * @brief The start of a capture file.
+ */
+struct CaptureHeader {
+	char Magic[4] = { 'S', 'R', 'C', 'P' };	// Identifies the file
+	std::uint32_t Version = 3;				// Format version
+	std::uint32_t ByteOrder = 0x01020304;	// Reads back as this only on a machine with the same byte order
+	std::int32_t Width = 0;					// Framebuffer width when captured
+	std::int32_t Height = 0;				// Framebuffer height when captured
+	std::uint32_t FrameCount = 0;			// Number of frames in the file, written when the capture stops
+
+};
+
+/**
+ * @class CaptureInstance
+ * @brief Records every object drawn through RendererInstance for a number of frames.
+ * @note Give it to RendererInstance.SetCapture(). Recording starts on the next StartFrame() and stops by itself after the frame count.
+ * @note Resources are recorded the first time they are drawn, reading the buffers back from the GPU, so objects made before the capture started are captured too.
+ * @note Model matrices are only written when they change, so static objects cost one draw record per frame.
+ * @warning Only RenderObject() draws and the camera are captured. Material batches, sprite batches, GPU culled draws and lighting are not. Using them writes an Unsupported record, so the replay knows it is not the same frame.
+ */
+class CaptureInstance {
+public:
+	CaptureInstance() {}		// Default constructor
+
+	/**
+	 * @brief Constructor which opens the capture file.
+	 * @param Path Path of the file to write.
+	 * @param _FrameCount Number of frames to record.
+	 */
+	CaptureInstance(const std::string& Path, int _FrameCount) : FrameCount(_FrameCount) {
+		File.open(Path, std::ios::binary | std::ios::trunc);
+		if(!File.is_open()) {
+			SR_LOG_ERROR("CaptureInstance: Constructor: %s could not be opened.", Path.c_str());
+			return;
+
+		}
+
+		// Writing a placeholder header, filled in when the capture stops
+		File.write((const char*)&Header, sizeof(Header));
+
+		// Setting the guard
+		Recording = FrameCount > 0;
+
+	}
+
+	/**
+	 * @brief Function to check if the capture is still recording.
+	 * @return Returns a bool of whether frames are still being recorded.
+	 */
+	bool IsRecording() {
+		return Recording;
+
+	}
+
+	/**
+	 * @brief Function to get the number of frames recorded so far.
+	 * @return Returns the number of finished frames.
+	 */
+	int GetRecordedFrames() {
+		return (int)Header.FrameCount;
+
+	}
+
+	/**
+	 * @brief Starts a frame. Called by RendererInstance.StartFrame().
+	 * @param Width Framebuffer width, the first frame's is kept.
+	 * @param Height Framebuffer height, the first frame's is kept.
+	 * @param View Pointer to the view matrix.
+	 * @param Perspective Pointer to the perspective matrix.
+	 */
+	void BeginFrame(int Width, int Height, const float* View, const float* Perspective) {
+		if(!Recording) {
+			return;
+
+		}
+
+		// Keeping the size of the first frame
+		if(Header.FrameCount == 0) {
+			Header.Width = Width;
+			Header.Height = Height;
+
+		}
+
+		WriteRecord(CaptureRecord::Frame);
+		Write(View, sizeof(float) * 16);
+		Write(Perspective, sizeof(float) * 16);
+
+	}
+
+	/**
+	 * @brief Records an object being drawn. Called by RendererInstance.RenderObject().
+	 * @param Object The object, which must be able to render.
+	 * @note Reads the object's buffers back the first time they are seen, which stalls. Only happens once per mesh.
+	 */
+	void RecordDraw(ObjectInstance* Object) {
+		if(!Recording) {
+			return;
+
+		}
+
+		// Recording the mesh the first time it is seen
+		std::uint32_t ID;
+		auto Found = MeshIDs.find(GetMeshKey(Object));
+		if(Found == MeshIDs.end()) {
+			ID = RecordMesh(Object);
+
+		} else {
+			ID = Found->second;
+
+		}
+
+		// Only writing the model matrix if it changed
+		const float* Model = Object->GetModelMatrix();
+		if(std::memcmp(Model, glm::value_ptr(LastModels[ID]), sizeof(float) * 16) != 0) {
+			std::memcpy(glm::value_ptr(LastModels[ID]), Model, sizeof(float) * 16);
+			WriteRecord(CaptureRecord::Transform);
+			Write(&ID, sizeof(ID));
+			Write(Model, sizeof(float) * 16);
+
+		}
+
+		WriteRecord(CaptureRecord::Draw);
+		Write(&ID, sizeof(ID));
+
+	}
+
+	/**
+	 * @brief Records that a renderer feature the capture cannot replay was used. Called by RendererInstance.
+	 * @param What Name of the feature, e.g "material batches". Must be a string literal.
+	 * @note Only written the first time each feature is used.
+	 */
+	void RecordUnsupported(const char* What) {
+		if(!Recording || std::find(Unsupported.begin(), Unsupported.end(), What) != Unsupported.end()) {
+			return;
+
+		}
+
+		Unsupported.push_back(What);
+		SR_LOG_WARNING("CaptureInstance: RecordUnsupported(): %s are not recorded, the replay will not draw them.", What);
+
+		WriteRecord(CaptureRecord::Unsupported);
+		WriteString(What);
+
+	}
+
+	/**
+	 * @brief Ends a frame, stopping the capture if it has enough frames. Called by RendererInstance.FinishFrame().
+	 */
+	void EndFrame() {
+		if(!Recording) {
+			return;
+
+		}
+
+		WriteRecord(CaptureRecord::FrameEnd);
+		Header.FrameCount++;
+
+		// Stopping once there are enough frames
+		if((int)Header.FrameCount >= FrameCount) {
+			Stop();
+
+		}
+
+	}
+
+	/**
+	 * @brief Stops recording and finishes the file.
+	 * @note Called by the destructor, so captures stopped early are still valid.
+	 */
+	void Stop() {
+		if(!Recording) {
+			return;
+
+		}
+
+		// Ending the file and filling in the header
+		WriteRecord(CaptureRecord::End);
+		File.seekp(0);
+		File.write((const char*)&Header, sizeof(Header));
+		File.close();
+
+		Recording = false;
+
+	}
+
+	/**
+	 * @brief Finishes the file if it is still recording.
+	 */
+	~CaptureInstance() {
+		Stop();
+
+	}
+
+private:
+	typedef std::tuple<std::uint64_t, ShaderInstance*> MeshKey;	// Mesh generation and shader of a mesh
+
+	/**
+	 * @brief Writes raw bytes to the file.
+	 */
+	void Write(const void* Data, std::size_t Size) {
+		File.write((const char*)Data, Size);
+
+	}
+
+	/**
+	 * @brief Writes the type byte of a record.
+	 */
+	void WriteRecord(CaptureRecord Type) {
+		std::uint8_t Byte = (std::uint8_t)Type;
+		Write(&Byte, 1);
+
+	}
+
+	/**
+	 * @brief Writes a length prefixed string.
+	 */
+	void WriteString(const std::string& String) {
+		std::uint32_t Length = (std::uint32_t)String.size();
+		Write(&Length, sizeof(Length));
+		Write(String.data(), Length);
+
+	}
+
+	/**
+	 * @brief Writes a shader record the first time a shader is seen.
+	 * @return Returns the ID of the shader in the capture.
+	 */
+	std::uint32_t RecordShader(ShaderInstance* Shader) {
+		auto Found = ShaderIDs.find(Shader);
+		if(Found != ShaderIDs.end()) {
+			return Found->second;
+
+		}
+
+		std::uint32_t ID = (std::uint32_t)ShaderIDs.size();
+		ShaderIDs[Shader] = ID;
+
+		// Writing the sources the program was compiled from, so the capture does not need the files
+		WriteRecord(CaptureRecord::Shader);
+		Write(&ID, sizeof(ID));
+		WriteString(Shader->GetVertexSource());
+		WriteString(Shader->GetFragmentSource());
+
+		return ID;
+
+	}
+
+	/**
+	 * @brief Makes the key a mesh is found by, from what is drawn rather than which object draws it.
+	 * @note Objects sharing a mesh share a key. Keyed on the mesh generation rather than the buffer names, since GL reuses the names of deleted buffers and a new mesh would get the old one's key.
+	 */
+	static MeshKey GetMeshKey(ObjectInstance* Object) {
+		return MeshKey(Object->GetMeshGeneration(), Object->GetShader());
+
+	}
+
+	/**
+	 * @brief Writes a mesh record the first time a mesh is seen.
+	 * @return Returns the ID of the mesh in the capture.
+	 */
+	std::uint32_t RecordMesh(ObjectInstance* Object) {
+		std::uint32_t ShaderID = RecordShader(Object->GetShader());
+
+		std::uint32_t ID = (std::uint32_t)MeshIDs.size();
+		MeshIDs[GetMeshKey(Object)] = ID;
+
+		// Making sure the first transform gets written
+		LastModels.push_back(glm::mat4(0.0f));
+
+		// Reading the buffers back
+		GetContentFromBuffer(Object->GetVertexBuffer(), Scratch);
+		std::uint32_t IndicesCount = (std::uint32_t)Object->GetIndicesCount();
+		std::uint32_t VertexBytes = (std::uint32_t)Scratch.size();
+
+		WriteRecord(CaptureRecord::Mesh);
+		Write(&ID, sizeof(ID));
+		Write(&ShaderID, sizeof(ShaderID));
+		Write(&IndicesCount, sizeof(IndicesCount));
+
+		// Writing the vertex layout
+		std::uint32_t Stride = (std::uint32_t)Object->GetVertexStride();
+		std::uint32_t AttributeCount = (std::uint32_t)Object->GetVertexLayoutCount();
+		Write(&Stride, sizeof(Stride));
+		Write(&AttributeCount, sizeof(AttributeCount));
+		for(std::uint32_t Index = 0; Index < AttributeCount; Index++) {
+			const VertexAttributeLayout& Attribute = Object->GetVertexLayout()[Index];
+			std::uint32_t Fields[3] = { Attribute.Location, (std::uint32_t)Attribute.Components, (std::uint32_t)Attribute.Type };
+			std::uint8_t Flags[2] = { Attribute.Normalized, Attribute.Integer };
+			std::uint32_t Offset = (std::uint32_t)Attribute.Offset;
+			Write(Fields, sizeof(Fields));
+			Write(Flags, sizeof(Flags));
+			Write(&Offset, sizeof(Offset));
+			
+		}
+
+		Write(&VertexBytes, sizeof(VertexBytes));
+		Write(Scratch.data(), Scratch.size());
+
+		// Only writing the indices that get drawn
+		GetContentFromBuffer(Object->GetIndexBuffer(), Scratch);
+		Scratch.resize(IndicesCount * sizeof(unsigned int));
+		Write(Scratch.data(), Scratch.size());
+
+		return ID;
+
+	}
+
+	std::ofstream File;					// The capture file
+	CaptureHeader Header;				// Header, written again when the capture stops
+	int FrameCount = 0;					// Frames to record
+	bool Recording = false;				// Bool guard determining whether frames are being recorded
+
+	std::unordered_map<ShaderInstance*, std::uint32_t> ShaderIDs;	// Capture IDs of shaders already written
+	std::map<MeshKey, std::uint32_t> MeshIDs;						// Capture IDs of meshes already written
+	std::vector<glm::mat4> LastModels;	// Last model matrix written for each mesh
+	std::vector<const char*> Unsupported;	// Features already written as unsupported
+	std::vector<char> Scratch;			// Space for reading buffers back
+
+};
@@ -0,0 +1,551 @@
+/**
+ * @file gpuculling.h
+ * @brief Contains GPU culling, which frustum culls instances in a compute shader and draws the survivors with one indirect draw.
+ * @note Instance transforms, per mesh bounds and the draw commands all live in GPU buffers. The compute shader counts the visible instances of each mesh straight into the indirect buffer, so the CPU never sees the results.
+ * @note Needs GL 4.3 for compute shaders, storage buffers and glMultiDrawElementsIndirect. Works on Mesa's llvmpipe.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/camera.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+#include <SimpleRenderer/object.h>
+#include <SimpleRenderer/vertex.h>
+
+/**
+ * @class GPUCullingInstance
+ * @brief Many instances of a few meshes, culled and drawn on the GPU.
+ * @note Add meshes, then instances of them, and draw it with RendererInstance.RenderGPUCulled().
+ * @note The vertex shader gets the instance through an integer attribute and reads its model matrix from a storage buffer, i.e:
+ * - layout(location = 15) in uint iInstance;
+ * - layout(std430, binding = 0) readonly buffer SRTransforms { mat4 uTransforms[]; };
+ * @note See examples/gpuculling for a full shader. The location can be changed in the constructor.
+ * @warning Adding a mesh reads its vertices back to work out its bounds, so it stalls. Meant for load time.
+ */
+class GPUCullingInstance {
+public:
+	static const int TransformBinding = 0;		// Storage buffer binding of the model matrices, also read by the vertex shader
+
+	/**
+	 * @brief Constructor which compiles the culling shader and makes the buffers.
+	 * @param _InstanceLocation Attribute location the vertex shader reads the instance index from.
+	 * @note Nothing can be added if the shader fails to compile or link, the error is logged.
+	 */
+	GPUCullingInstance(unsigned int _InstanceLocation = 15) : InstanceLocation(_InstanceLocation) {
+		// Guard checking
+		if(!IsSupported()) {
+			SR_LOG_ERROR("GPUCullingInstance: GPUCullingInstance(): GL 4.3 is needed for GPU culling.");
+			return;
+
+		}
+
+		// Compiling the culling shader
+		unsigned int Shader = glCreateShader(GL_COMPUTE_SHADER);
+		glShaderSource(Shader, 1, &CullSource, NULL);
+		glCompileShader(Shader);
+
+		// Compile error checking
+		int Success;
+		glGetShaderiv(Shader, GL_COMPILE_STATUS, &Success);
+		if(!Success) {
+			char InfoLog[512];
+			glGetShaderInfoLog(Shader, 512, NULL, InfoLog);
+			SR_LOG_ERROR("GPUCullingInstance: GPUCullingInstance(): Culling shader compilation failed. Info Log: %s", InfoLog);
+			glDeleteShader(Shader);
+			return;
+		}
+
+		// Linking it
+		Program = glCreateProgram();
+		glAttachShader(Program, Shader);
+		glLinkProgram(Program);
+		glDeleteShader(Shader);
+		glGetProgramiv(Program, GL_LINK_STATUS, &Success);
+		if(!Success) {
+			char InfoLog[512];
+			glGetProgramInfoLog(Program, 512, NULL, InfoLog);
+			SR_LOG_ERROR("GPUCullingInstance: GPUCullingInstance(): Culling shader linking failed. Info Log: %s", InfoLog);
+			glDeleteProgram(Program);
+			Program = 0;
+			return;
+		}
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Program, Program, MemoryTrackerInstance::GetProgramSize(Program), "GPUCullingInstance culling shader");
+
+		PlanesLocation = glGetUniformLocation(Program, "uPlanes");
+		CountLocation = glGetUniformLocation(Program, "uInstanceCount");
+
+		// Making the buffers and the VAO
+		glGenBuffers(BufferCount, Buffers);
+		glGenVertexArrays(1, &VAO);
+		HasProgram = true;
+
+	}
+
+	/**
+	 * @brief Checks if the context can do GPU culling.
+	 * @return Returns a bool of whether GL 4.3 is there.
+	 */
+	static bool IsSupported() {
+		return GLEW_VERSION_4_3;
+
+	}
+
+	/**
+	 * @brief Adds a mesh, copying its buffers on the GPU so the object can be deleted after.
+	 * @param Object The object, which must have finished uploading. Its model matrix is ignored.
+	 * @return Returns the index of the mesh, or -1 if it could not be added.
+	 * @note Every mesh must have the same vertex layout, with a float vec3 position at location 0. The position can be anywhere in the vertex.
+	 */
+	int AddMesh(ObjectInstance* Object) {
+		// Guard checking
+		Object->Poll();
+		if(!HasProgram || !Object->CanRender()) {
+			SR_LOG_ERROR("GPUCullingInstance: AddMesh(): Culling is not set up or object has no vertex data.");
+			return -1;
+
+		}
+
+		// Taking the layout from the first mesh
+		if(Meshes.empty()) {
+			Stride = Object->GetVertexStride();
+			Layout.assign(Object->GetVertexLayout(), Object->GetVertexLayout() + Object->GetVertexLayoutCount());
+			const VertexAttributeLayout* Position = FindVertexAttribute(Layout.data(), (int)Layout.size(), 0);
+			if(!Position || Position->Components != 3 || Position->Type != GL_FLOAT || Position->Integer) {
+				SR_LOG_ERROR("GPUCullingInstance: AddMesh(): Attribute 0 must be a vec3 position.");
+				Layout.clear();
+				return -1;
+
+			}
+			PositionOffset = Position->Offset;
+
+		} else if(!Object->HasVertexLayout(Layout.data(), (int)Layout.size(), Stride)) {
+			SR_LOG_ERROR("GPUCullingInstance: AddMesh(): Object has a different vertex layout to the other meshes.");
+			return -1;
+
+		}
+
+		// Working out the bounding sphere from the positions
+		std::vector<char> Vertices;
+		GetContentFromBuffer(Object->GetVertexBuffer(), Vertices);
+		std::size_t VertexCount = Vertices.size() / Stride;
+		std::vector<glm::vec3> Positions(VertexCount);
+		for(std::size_t Index = 0; Index < VertexCount; Index++) {
+			std::memcpy(&Positions[Index], Vertices.data() + Index * Stride + PositionOffset, sizeof(glm::vec3));
+
+		}
+		glm::vec3 Min(0.0f), Max(0.0f);
+		for(std::size_t Index = 0; Index < VertexCount; Index++) {
+			Min = Index == 0 ? Positions[Index] : glm::min(Min, Positions[Index]);
+			Max = Index == 0 ? Positions[Index] : glm::max(Max, Positions[Index]);
+
+		}
+		glm::vec3 Center = (Min + Max) * 0.5f;
+		float Radius = 0.0f;
+		for(const glm::vec3& Position : Positions) {
+			glm::vec3 Offset = Position - Center;
+			Radius = std::max(Radius, glm::dot(Offset, Offset));
+
+		}
+
+		// Appending the buffers to the shared ones
+		Mesh Current;
+		Current.Bounds = glm::vec4(Center, std::sqrt(Radius));
+		Current.FirstIndex = IndexCount;
+		Current.BaseVertex = (int)(VertexBytes / Stride);
+		Current.IndexCount = Object->GetIndicesCount();
+		VertexBytes = Append(Buffers[VertexBuffer], VertexBytes, Object->GetVertexBuffer(), Vertices.size());
+		IndexCount = (int)(Append(Buffers[IndexBuffer], (std::size_t)IndexCount * sizeof(unsigned int), Object->GetIndexBuffer(), (std::size_t)Current.IndexCount * sizeof(unsigned int)) / sizeof(unsigned int));
+		Meshes.push_back(Current);
+
+		// The VAO points at the old buffers, so setting it up again
+		SetupVAO();
+		InstancesChanged = true;
+		return (int)Meshes.size() - 1;
+
+	}
+
+	/**
+	 * @brief Adds an instance of a mesh.
+	 * @param MeshIndex Index returned by AddMesh().
+	 * @param Model Model matrix of the instance.
+	 * @return Returns the index of the instance, or -1 if the mesh does not exist.
+	 */
+	int AddInstance(int MeshIndex, const glm::mat4& Model) {
+		// Guard checking
+		if(MeshIndex < 0 || MeshIndex >= (int)Meshes.size()) {
+			SR_LOG_ERROR("GPUCullingInstance: AddInstance(): Mesh %d does not exist.", MeshIndex);
+			return -1;
+
+		}
+
+		Transforms.push_back(Model);
+		InstanceMeshes.push_back((unsigned int)MeshIndex);
+		Meshes[MeshIndex].InstanceCount++;
+		InstancesChanged = true;
+		return (int)Transforms.size() - 1;
+
+	}
+
+	/**
+	 * @brief Moves an instance. Only the changed range is uploaded before the next cull.
+	 * @param Instance Index returned by AddInstance().
+	 * @param Model The new model matrix.
+	 */
+	void SetTransform(int Instance, const glm::mat4& Model) {
+		if(Instance < 0 || Instance >= (int)Transforms.size()) {
+			SR_LOG_ERROR("GPUCullingInstance: SetTransform(): Instance %d does not exist.", Instance);
+			return;
+
+		}
+
+		Transforms[Instance] = Model;
+		DirtyMin = std::min(DirtyMin, Instance);
+		DirtyMax = std::max(DirtyMax, Instance + 1);
+
+	}
+
+	/**
+	 * @brief Culls every instance against the view and writes the draw commands. Called by RendererInstance.RenderGPUCulled().
+	 * @param ViewProjection The perspective matrix times the view matrix.
+	 */
+	void Cull(const glm::mat4& ViewProjection) {
+		if(!HasProgram || Transforms.empty()) {
+			return;
+
+		}
+
+		Upload();
+
+		// Normalized planes, so sphere radii can be compared directly
+		glm::vec4 Planes[6];
+		GetFrustumPlanes(ViewProjection, Planes);
+
+		// Zeroing the instance counts by copying the commands over from the template
+		glBindBuffer(GL_COPY_READ_BUFFER, Buffers[TemplateBuffer]);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, Buffers[CommandBuffer]);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, Meshes.size() * sizeof(DrawCommand));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		// Culling
+		glUseProgram(Program);
+		glUniform4fv(PlanesLocation, 6, glm::value_ptr(Planes[0]));
+		glUniform1ui(CountLocation, (unsigned int)Transforms.size());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TransformBinding, Buffers[TransformBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, Buffers[MeshIndexBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, Buffers[BoundsBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, Buffers[CommandBuffer]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, Buffers[VisibleBuffer]);
+		glDispatchCompute(((unsigned int)Transforms.size() + GroupSize - 1) / GroupSize, 1, 1);
+
+		// Making the writes visible to the indirect draw and the instance attribute
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	}
+
+	/**
+	 * @brief Draws the instances that survived the last cull. Called by RendererInstance.RenderGPUCulled().
+	 * @note The shader must already be in use. Binds the transforms for the vertex shader to read.
+	 */
+	void Draw() {
+		if(!HasProgram || Transforms.empty()) {
+			return;
+
+		}
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TransformBinding, Buffers[TransformBuffer]);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, Buffers[CommandBuffer]);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (int)Meshes.size(), 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	}
+
+	/**
+	 * @brief Reads the number of instances that survived the last cull back from the GPU.
+	 * @return Returns the visible instance count.
+	 * @warning Waits for the GPU to finish culling. Meant for debugging and tests, not every frame.
+	 */
+	int ReadVisibleCount() {
+		if(!HasProgram || Meshes.empty()) {
+			return 0;
+
+		}
+
+		std::vector<DrawCommand> Commands(Meshes.size());
+		glBindBuffer(GL_COPY_READ_BUFFER, Buffers[CommandBuffer]);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, 0, Commands.size() * sizeof(DrawCommand), Commands.data());
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		int Count = 0;
+		for(const DrawCommand& Command : Commands) {
+			Count += (int)Command.InstanceCount;
+
+		}
+		return Count;
+
+	}
+
+	/**
+	 * @brief Function to get the number of meshes.
+	 * @return Returns the mesh count.
+	 */
+	int GetMeshCount() {
+		return (int)Meshes.size();
+
+	}
+
+	/**
+	 * @brief Function to get the number of instances.
+	 * @return Returns the instance count.
+	 */
+	int GetInstanceCount() {
+		return (int)Transforms.size();
+
+	}
+
+	/**
+	 * @brief Deletes the buffers, VAO and culling shader.
+	 */
+	~GPUCullingInstance() {
+		if(!HasProgram) {
+			return;
+
+		}
+
+		for(unsigned int Buffer : Buffers) {
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, Buffer);
+
+		}
+		glDeleteBuffers(BufferCount, Buffers);
+		glDeleteVertexArrays(1, &VAO);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Program, Program);
+		glDeleteProgram(Program);
+
+	}
+
+private:
+	/**
+	 * @struct DrawCommand
+	 * @brief Matches the layout glMultiDrawElementsIndirect reads, and the Command struct in the shader.
+	 */
+	struct DrawCommand {
+		unsigned int Count;				// Number of indices
+		unsigned int InstanceCount;		// Number of visible instances, written by the shader
+		unsigned int FirstIndex;		// Offset into the shared index buffer
+		int BaseVertex;					// Offset into the shared vertex buffer
+		unsigned int BaseInstance;		// Start of the mesh's range in the visible list
+
+	};
+
+	/**
+	 * @struct Mesh
+	 * @brief A mesh in the shared buffers.
+	 */
+	struct Mesh {
+		glm::vec4 Bounds;				// Bounding sphere in model space, center and radius
+		int FirstIndex = 0;				// Offset into the shared index buffer
+		int BaseVertex = 0;				// Offset into the shared vertex buffer
+		int IndexCount = 0;				// Number of indices
+		int InstanceCount = 0;			// Number of instances using the mesh
+
+	};
+
+	// Indices into Buffers
+	enum { VertexBuffer, IndexBuffer, TransformBuffer, MeshIndexBuffer, BoundsBuffer, CommandBuffer, TemplateBuffer, VisibleBuffer, BufferCount };
+
+	static const unsigned int GroupSize = 64;		// Instances per work group
+
+	// Tests each instance's bounding sphere and appends the visible ones to their mesh's range
+	static constexpr const char* CullSource = R"(#version 430 core
+layout(local_size_x = 64) in;
+
+struct Command {
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	int BaseVertex;
+	uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer SRTransforms { mat4 uTransforms[]; };
+layout(std430, binding = 1) readonly buffer SRMeshes { uint uMeshes[]; };
+layout(std430, binding = 2) readonly buffer SRBounds { vec4 uBounds[]; };
+layout(std430, binding = 3) buffer SRCommands { Command uCommands[]; };
+layout(std430, binding = 4) writeonly buffer SRVisible { uint uVisible[]; };
+
+uniform vec4 uPlanes[6];
+uniform uint uInstanceCount;
+
+void main() {
+	uint Index = gl_GlobalInvocationID.x;
+	if(Index >= uInstanceCount) {
+		return;
+	}
+
+	// Moving the sphere into world space, scaling the radius by the largest axis
+	uint Mesh = uMeshes[Index];
+	mat4 Model = uTransforms[Index];
+	vec4 Bounds = uBounds[Mesh];
+	vec3 Center = (Model * vec4(Bounds.xyz, 1.0)).xyz;
+	float Radius = Bounds.w * sqrt(max(dot(Model[0].xyz, Model[0].xyz), max(dot(Model[1].xyz, Model[1].xyz), dot(Model[2].xyz, Model[2].xyz))));
+
+	for(int Plane = 0; Plane < 6; Plane++) {
+		if(dot(uPlanes[Plane].xyz, Center) + uPlanes[Plane].w < -Radius) {
+			return;
+		}
+	}
+
+	uint Slot = atomicAdd(uCommands[Mesh].InstanceCount, 1u);
+	uVisible[uCommands[Mesh].BaseInstance + Slot] = Index;
+}
+)";
+
+	/**
+	 * @brief Uploads whatever changed since the last cull.
+	 */
+	void Upload() {
+		if(InstancesChanged) {
+			// Giving each mesh a range of the visible list as big as its instance count
+			std::vector<DrawCommand> Commands(Meshes.size());
+			std::vector<glm::vec4> Bounds(Meshes.size());
+			unsigned int BaseInstance = 0;
+			for(std::size_t Index = 0; Index < Meshes.size(); Index++) {
+				Commands[Index] = { (unsigned int)Meshes[Index].IndexCount, 0, (unsigned int)Meshes[Index].FirstIndex, Meshes[Index].BaseVertex, BaseInstance };
+				Bounds[Index] = Meshes[Index].Bounds;
+				BaseInstance += Meshes[Index].InstanceCount;
+
+			}
+
+			// Uploading everything again
+			BufferData(TransformBuffer, Transforms.size() * sizeof(glm::mat4), Transforms.data(), GL_DYNAMIC_DRAW);
+			BufferData(MeshIndexBuffer, InstanceMeshes.size() * sizeof(unsigned int), InstanceMeshes.data(), GL_STATIC_DRAW);
+			BufferData(BoundsBuffer, Bounds.size() * sizeof(glm::vec4), Bounds.data(), GL_STATIC_DRAW);
+			BufferData(CommandBuffer, Commands.size() * sizeof(DrawCommand), Commands.data(), GL_DYNAMIC_COPY);
+			BufferData(TemplateBuffer, Commands.size() * sizeof(DrawCommand), Commands.data(), GL_STATIC_COPY);
+			BufferData(VisibleBuffer, Transforms.size() * sizeof(unsigned int), nullptr, GL_DYNAMIC_COPY);
+
+			InstancesChanged = false;
+			DirtyMin = (int)Transforms.size();
+			DirtyMax = 0;
+
+		} else if(DirtyMin < DirtyMax) {
+			// Uploading only the moved transforms
+			glBindBuffer(GL_COPY_WRITE_BUFFER, Buffers[TransformBuffer]);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, DirtyMin * sizeof(glm::mat4), (DirtyMax - DirtyMin) * sizeof(glm::mat4), &Transforms[DirtyMin]);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+			DirtyMin = (int)Transforms.size();
+			DirtyMax = 0;
+
+		}
+
+	}
+
+	/**
+	 * @brief Points the VAO at the shared buffers, with the visible list as a per instance attribute.
+	 * @note The base instance of each draw offsets the attribute, which is how each mesh reads its own range.
+	 */
+	void SetupVAO() {
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, Buffers[VertexBuffer]);
+		for(const VertexAttributeLayout& Attribute : Layout) {
+			glEnableVertexAttribArray(Attribute.Location);
+			if(Attribute.Integer) {
+				glVertexAttribIPointer(Attribute.Location, Attribute.Components, Attribute.Type, Stride, (void*)Attribute.Offset);
+
+			} else {
+				glVertexAttribPointer(Attribute.Location, Attribute.Components, Attribute.Type, Attribute.Normalized ? GL_TRUE : GL_FALSE, Stride, (void*)Attribute.Offset);
+
+			}
+
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, Buffers[VisibleBuffer]);
+		glEnableVertexAttribArray(InstanceLocation);
+		glVertexAttribIPointer(InstanceLocation, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void*)0);
+		glVertexAttribDivisor(InstanceLocation, 1);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Buffers[IndexBuffer]);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	}
+
+	/**
+	 * @brief Grows a buffer and copies another buffer onto the end of it, all on the GPU.
+	 * @param Buffer The buffer to grow, replaced by the new one.
+	 * @param Size Bytes used in Buffer.
+	 * @param Source Buffer to copy from.
+	 * @param SourceSize Bytes to copy from Source.
+	 * @return Returns the new used size.
+	 */
+	std::size_t Append(unsigned int& Buffer, std::size_t Size, unsigned int Source, std::size_t SourceSize) {
+		unsigned int Grown;
+		glGenBuffers(1, &Grown);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, Grown);
+		glBufferData(GL_COPY_WRITE_BUFFER, Size + SourceSize, nullptr, GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Grown, Size + SourceSize, "GPUCullingInstance meshes");
+
+		if(Size > 0) {
+			glBindBuffer(GL_COPY_READ_BUFFER, Buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, Size);
+
+		}
+		glBindBuffer(GL_COPY_READ_BUFFER, Source);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, Size, SourceSize);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, Buffer);
+		glDeleteBuffers(1, &Buffer);
+		Buffer = Grown;
+		return Size + SourceSize;
+
+	}
+
+	/**
+	 * @brief Reallocates one of the buffers with new data.
+	 */
+	void BufferData(int Index, std::size_t Size, const void* Data, GLenum Usage) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, Buffers[Index]);
+		glBufferData(GL_COPY_WRITE_BUFFER, std::max<std::size_t>(Size, 4), Data, Usage);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Buffers[Index], std::max<std::size_t>(Size, 4), "GPUCullingInstance instances");
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	}
+
+	unsigned int InstanceLocation = 15;		// Attribute location of the instance index
+	bool HasProgram = false;				// Bool guard determining whether the shader and buffers were made
+	unsigned int Program = 0;				// The culling compute shader
+	int PlanesLocation = -1;				// Location of uPlanes
+	int CountLocation = -1;					// Location of uInstanceCount
+	unsigned int Buffers[BufferCount] = {};	// Every buffer, see the enum above
+	unsigned int VAO = 0;					// VAO over the shared buffers
+
+	std::vector<VertexAttributeLayout> Layout;	// Vertex layout of every mesh
+	int Stride = 0;							// Size of a vertex in bytes
+	std::size_t PositionOffset = 0;			// Offset of the position in a vertex
+	std::size_t VertexBytes = 0;			// Bytes used in the shared vertex buffer
+	int IndexCount = 0;						// Indices in the shared index buffer
+	std::vector<Mesh> Meshes;				// Every mesh
+
+	std::vector<glm::mat4> Transforms;		// Model matrix of every instance
+	std::vector<unsigned int> InstanceMeshes;	// Mesh of every instance
+	bool InstancesChanged = false;			// Whether instances or meshes were added since the last upload
+	int DirtyMin = 0;						// First transform changed since the last upload
+	int DirtyMax = 0;						// One past the last transform changed since the last upload
+
+};
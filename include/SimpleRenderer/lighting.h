@@ -0,0 +1,426 @@
+/**
+ * @file lighting.h
+ * @brief Contains point lights and clustered light binning.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <SimpleRenderer/memory.h>
+#include <SimpleRenderer/shader.h>
+
+/**
+ * @struct PointLight
+ * @brief A point light with a hard cutoff radius.
+ */
+struct PointLight {
+	glm::vec3 Position = glm::vec3(0.0f);	// World position
+	float Radius = 1.0f;					// Distance at which the light stops affecting anything
+	glm::vec3 Color = glm::vec3(1.0f);		// Color of the light
+	float Intensity = 1.0f;					// Brightness multiplier
+
+};
+
+/**
+ * @class ClusteredLightingInstance
+ * @brief Splits the view frustum into a 3D grid of clusters and works out which lights touch each one, every frame.
+ * @note Binning is split over worker threads by depth slice, so no two threads ever write the same cluster.
+ * @note Depth slices are spaced exponentially between the near and far planes, so clusters stay roughly cube shaped.
+ * @note The results go to three texture buffers, which shaders read with these uniforms:
+ * - uClusterLights (samplerBuffer): 2 texels per light, view space position and radius, then color times intensity.
+ * - uClusterGrid (usamplerBuffer): 1 texel per cluster, offset into the index list and light count.
+ * - uClusterIndices (usamplerBuffer): the light index lists of all clusters back to back.
+ * - uClusterSize (vec4): grid size in x, y and z.
+ * - uClusterDepth (vec4): near plane, far plane and log(far / near).
+ * @note Cluster x and y come from the fragment's NDC position, z from its view space depth. See examples/lights3d for a shader which walks the lists.
+ * @warning The renderer must be initialized before creating this.
+ */
+class ClusteredLightingInstance {
+public:
+	static const int FirstTextureUnit = 13;		// Texture units 13, 14 and 15 are used for the buffers
+
+	/**
+	 * @brief Constructor which makes the buffers and starts the worker threads.
+	 * @param _GridX Number of clusters across.
+	 * @param _GridY Number of clusters down.
+	 * @param _GridZ Number of depth slices.
+	 * @param _ThreadCount Number of threads binning, including the calling thread. 0 uses the hardware thread count.
+	 */
+	ClusteredLightingInstance(int _GridX = 16, int _GridY = 9, int _GridZ = 24, int _ThreadCount = 0) :
+		GridX(std::max(1, _GridX)),
+		GridY(std::max(1, _GridY)),
+		GridZ(std::max(1, _GridZ))
+	{
+		// Working out the thread count, no point having more threads than slices
+		int ThreadCount = _ThreadCount > 0 ? _ThreadCount : (int)std::thread::hardware_concurrency();
+		ThreadCount = std::clamp(ThreadCount, 1, GridZ);
+
+		// Making space for the clusters
+		ClusterLists.resize(GridX * GridY * GridZ);
+		Grid.resize(ClusterLists.size() * 2);
+
+		// Making the buffers and their textures
+		glGenBuffers(3, Buffers);
+		glGenTextures(3, Textures);
+		const GLenum Formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+		for(int Index = 0; Index < 3; Index++) {
+			glBindBuffer(GL_TEXTURE_BUFFER, Buffers[Index]);
+			glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+			MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Buffers[Index], 16, "ClusteredLightingInstance buffer");
+			glBindTexture(GL_TEXTURE_BUFFER, Textures[Index]);
+			glTexBuffer(GL_TEXTURE_BUFFER, Formats[Index], Buffers[Index]);
+
+		}
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+		// Starting the workers, the calling thread is worker 0
+		for(int Worker = 1; Worker < ThreadCount; Worker++) {
+			Workers.emplace_back(&ClusteredLightingInstance::WorkerLoop, this, Worker);
+
+		}
+
+		// Setting the guard
+		LightingCreated = true;
+
+	}
+
+	/**
+	 * @brief Adds a light.
+	 * @param Light The light to add.
+	 * @return Returns the index of the light.
+	 */
+	int AddLight(const PointLight& Light) {
+		Lights.push_back(Light);
+		return (int)Lights.size() - 1;
+
+	}
+
+	/**
+	 * @brief Removes every light.
+	 */
+	void ClearLights() {
+		Lights.clear();
+
+	}
+
+	/**
+	 * @brief Function to get the lights, so they can be moved or changed.
+	 * @return Returns a reference to the lights.
+	 */
+	std::vector<PointLight>& GetLights() {
+		return Lights;
+
+	}
+
+	/**
+	 * @brief Bins the lights into clusters and uploads the results.
+	 * @param View The view matrix.
+	 * @param FOV The vertical field of view in degrees.
+	 * @param Aspect Width over height of the viewport.
+	 * @param _Near The near plane distance.
+	 * @param _Far The far plane distance.
+	 * @note Called by RendererInstance.StartFrame() when the lighting is set on the renderer.
+	 */
+	void Update(const glm::mat4& View, float FOV, float Aspect, float _Near, float _Far) {
+		// Guard checking
+		if(!LightingCreated) {
+			return;
+
+		}
+
+		Near = _Near;
+		Far = _Far;
+		LogDepthRatio = std::log(Far / Near);
+
+		// Scale from view space x/depth and y/depth to NDC, same as the perspective matrix
+		ProjectionY = 1.0f / std::tan(glm::radians(FOV) * 0.5f);
+		ProjectionX = ProjectionY / Aspect;
+
+		// Moving the lights into view space, this is also what the shader gets
+		LightTexels.resize(Lights.size() * 2);
+		for(std::size_t Index = 0; Index < Lights.size(); Index++) {
+			const PointLight& Light = Lights[Index];
+			glm::vec4 ViewPosition = View * glm::vec4(Light.Position, 1.0f);
+			LightTexels[Index * 2 + 0] = glm::vec4(ViewPosition.x, ViewPosition.y, ViewPosition.z, Light.Radius);
+			LightTexels[Index * 2 + 1] = glm::vec4(Light.Color * Light.Intensity, 0.0f);
+
+		}
+
+		// Binning, the workers and this thread each take a share of the depth slices
+		RunWorkers();
+
+		// Compacting the lists into one index list
+		Indices.clear();
+		for(std::size_t Cluster = 0; Cluster < ClusterLists.size(); Cluster++) {
+			Grid[Cluster * 2 + 0] = (std::uint32_t)Indices.size();
+			Grid[Cluster * 2 + 1] = (std::uint32_t)ClusterLists[Cluster].size();
+			Indices.insert(Indices.end(), ClusterLists[Cluster].begin(), ClusterLists[Cluster].end());
+
+		}
+
+		// Uploading, orphaning each buffer so last frame's draws can still read the old data
+		Upload(0, LightTexels.data(), LightTexels.size() * sizeof(glm::vec4));
+		Upload(1, Grid.data(), Grid.size() * sizeof(std::uint32_t));
+		Upload(2, Indices.data(), Indices.size() * sizeof(std::uint32_t));
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	}
+
+	/**
+	 * @brief Binds the buffers to their texture units.
+	 * @note Called by RendererInstance.StartFrame() after Update().
+	 */
+	void Bind() {
+		for(int Index = 0; Index < 3; Index++) {
+			glActiveTexture(GL_TEXTURE0 + FirstTextureUnit + Index);
+			glBindTexture(GL_TEXTURE_BUFFER, Textures[Index]);
+
+		}
+
+		glActiveTexture(GL_TEXTURE0);
+
+	}
+
+	/**
+	 * @brief Sets the lighting uniforms on a shader.
+	 * @param Shader The shader, which must be in use.
+	 * @note Called by RendererInstance.RenderObject() when the lighting is set on the renderer.
+	 */
+	void UseUniforms(ShaderInstance* Shader) {
+		Shader->UseInt("uClusterLights", FirstTextureUnit + 0);
+		Shader->UseInt("uClusterGrid", FirstTextureUnit + 1);
+		Shader->UseInt("uClusterIndices", FirstTextureUnit + 2);
+		Shader->UseVec4("uClusterSize", glm::vec4((float)GridX, (float)GridY, (float)GridZ, 0.0f));
+		Shader->UseVec4("uClusterDepth", glm::vec4(Near, Far, LogDepthRatio, 0.0f));
+
+	}
+
+	/**
+	 * @brief Function to get the total number of light references over all clusters.
+	 * @return Returns the length of the index list from the last Update().
+	 */
+	int GetIndexCount() {
+		return (int)Indices.size();
+
+	}
+
+	/**
+	 * @brief Stops the workers and deletes the buffers.
+	 */
+	~ClusteredLightingInstance() {
+		// Guard checking
+		if(!LightingCreated) {
+			return;
+
+		}
+
+		// Stopping the workers
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Stopping = true;
+		}
+		StartCondition.notify_all();
+		for(std::thread& Worker : Workers) {
+			Worker.join();
+
+		}
+
+		glDeleteTextures(3, Textures);
+		for(unsigned int Buffer : Buffers) {
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, Buffer);
+
+		}
+		glDeleteBuffers(3, Buffers);
+
+	}
+
+private:
+	/**
+	 * @brief Wakes the workers, does this thread's share and waits for the rest.
+	 */
+	void RunWorkers() {
+		// Waking the workers
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Generation++;
+			Remaining = (int)Workers.size();
+		}
+		StartCondition.notify_all();
+
+		// Doing this thread's share
+		BinSlices(0);
+
+		// Waiting for the rest
+		std::unique_lock<std::mutex> Lock(Mutex);
+		DoneCondition.wait(Lock, [this]() { return Remaining == 0; });
+
+	}
+
+	/**
+	 * @brief The loop each worker thread runs.
+	 * @param Worker Index of the worker, 0 is the calling thread.
+	 */
+	void WorkerLoop(int Worker) {
+		int SeenGeneration = 0;
+
+		while(true) {
+			// Waiting for a frame
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				StartCondition.wait(Lock, [&]() { return Stopping || Generation != SeenGeneration; });
+
+				if(Stopping) {
+					return;
+
+				}
+
+				SeenGeneration = Generation;
+			}
+
+			BinSlices(Worker);
+
+			// Saying this one is done
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Remaining--;
+			}
+			DoneCondition.notify_one();
+
+		}
+
+	}
+
+	/**
+	 * @brief Bins every light into one worker's share of the depth slices.
+	 * @param Worker Index of the worker.
+	 */
+	void BinSlices(int Worker) {
+		// Working out the share, slices are handed out round robin so near and far slices are spread out
+		int ThreadCount = (int)Workers.size() + 1;
+
+		for(int Slice = Worker; Slice < GridZ; Slice += ThreadCount) {
+			// Clearing last frame, keeps the memory
+			for(int Cluster = Slice * GridX * GridY; Cluster < (Slice + 1) * GridX * GridY; Cluster++) {
+				ClusterLists[Cluster].clear();
+
+			}
+
+			// Depth range of the slice
+			float SliceNear = Near * std::exp(LogDepthRatio * Slice / GridZ);
+			float SliceFar = Near * std::exp(LogDepthRatio * (Slice + 1) / GridZ);
+
+			for(std::size_t Index = 0; Index < Lights.size(); Index++) {
+				const glm::vec4& Light = LightTexels[Index * 2];
+				float Depth = -Light.z;
+				float Radius = Light.w;
+
+				// Skipping lights that dont reach this slice
+				float MinDepth = std::max(Depth - Radius, SliceNear);
+				float MaxDepth = std::min(Depth + Radius, SliceFar);
+				if(MinDepth > MaxDepth) {
+					continue;
+
+				}
+
+				// Getting the tile range the light covers within the slice
+				int MinX, MaxX, MinY, MaxY;
+				GetTileRange(Light.x, Radius, MinDepth, MaxDepth, ProjectionX, GridX, MinX, MaxX);
+				GetTileRange(Light.y, Radius, MinDepth, MaxDepth, ProjectionY, GridY, MinY, MaxY);
+
+				for(int Y = MinY; Y <= MaxY; Y++) {
+					for(int X = MinX; X <= MaxX; X++) {
+						ClusterLists[(Slice * GridY + Y) * GridX + X].push_back((std::uint32_t)Index);
+
+					}
+
+				}
+
+			}
+
+		}
+
+	}
+
+	/**
+	 * @brief Works out which tiles along one axis a light's bounding box covers.
+	 * @param Center View space position of the light on the axis.
+	 * @param Radius Radius of the light.
+	 * @param MinDepth Nearest depth of the light inside the slice, always positive.
+	 * @param MaxDepth Farthest depth of the light inside the slice.
+	 * @param Projection Scale from position over depth to NDC on the axis.
+	 * @param Tiles Number of tiles on the axis.
+	 * @param First Output first tile.
+	 * @param Last Output last tile.
+	 */
+	static void GetTileRange(float Center, float Radius, float MinDepth, float MaxDepth, float Projection, int Tiles, int& First, int& Last) {
+		// Projecting the box edges at both depths and keeping the extremes, which is conservative
+		float Low = Center - Radius;
+		float High = Center + Radius;
+		float MinNDC = std::min(Low / MinDepth, Low / MaxDepth) * Projection;
+		float MaxNDC = std::max(High / MinDepth, High / MaxDepth) * Projection;
+
+		// NDC to tiles
+		First = std::clamp((int)std::floor((MinNDC * 0.5f + 0.5f) * Tiles), 0, Tiles - 1);
+		Last = std::clamp((int)std::floor((MaxNDC * 0.5f + 0.5f) * Tiles), 0, Tiles - 1);
+
+		// Entirely off one side
+		if(MaxNDC < -1.0f || MinNDC > 1.0f) {
+			First = 1;
+			Last = 0;
+
+		}
+
+	}
+
+	/**
+	 * @brief Uploads data to one of the texture buffers.
+	 */
+	void Upload(int Index, const void* Data, std::size_t Size) {
+		glBindBuffer(GL_TEXTURE_BUFFER, Buffers[Index]);
+		glBufferData(GL_TEXTURE_BUFFER, std::max<std::size_t>(Size, 16), NULL, GL_STREAM_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Buffers[Index], std::max<std::size_t>(Size, 16), "ClusteredLightingInstance buffer");
+		if(Size > 0) {
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, Size, Data);
+
+		}
+
+	}
+
+	int GridX, GridY, GridZ;					// Grid size
+	float Near = 0.1f;							// Near plane of the last Update()
+	float Far = 100.0f;							// Far plane of the last Update()
+	float LogDepthRatio = 0.0f;					// log(Far / Near)
+	float ProjectionX = 1.0f;					// View space to NDC scale in x
+	float ProjectionY = 1.0f;					// View space to NDC scale in y
+
+	std::vector<PointLight> Lights;				// The lights, in world space
+	std::vector<glm::vec4> LightTexels;			// The lights in view space, as uploaded
+	std::vector<std::vector<std::uint32_t>> ClusterLists;	// Light indices per cluster, filled by the workers
+	std::vector<std::uint32_t> Grid;			// Offset and count per cluster, as uploaded
+	std::vector<std::uint32_t> Indices;			// All cluster lists back to back, as uploaded
+
+	unsigned int Buffers[3] = {};				// Light, grid and index buffers
+	unsigned int Textures[3] = {};				// Texture buffer views of the buffers
+	bool LightingCreated = false;				// Bool guard determining whether the buffers have been created
+
+	std::vector<std::thread> Workers;			// Worker threads, not including the calling thread
+	std::mutex Mutex;							// Protects the fields below
+	std::condition_variable StartCondition;		// Wakes the workers for a frame
+	std::condition_variable DoneCondition;		// Wakes the calling thread when the workers are done
+	int Generation = 0;							// Incremented every frame to wake the workers
+	int Remaining = 0;							// Workers still binning this frame
+	bool Stopping = false;						// Tells the workers to exit
+
+};
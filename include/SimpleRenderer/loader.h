@@ -0,0 +1,279 @@
+/**
+ * @file loader.h
+ * @brief Contains the background loader, which uploads resources on its own thread with a shared OpenGL context.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/window.h>
+
+/**
+ * @class UploadFence
+ * @brief Tracks a single job submitted to a LoaderInstance.
+ * @note Once the job has run, the loader puts a glFenceSync behind it. The render thread only uses the resource once that fence has signalled.
+ * @warning IsReady() and Wait() must be called from the render thread.
+ */
+class UploadFence {
+public:
+	/**
+	 * @brief Checks if the job has finished on the GPU, without blocking.
+	 * @return Returns a bool of whether the resource can be used.
+	 */
+	bool IsReady() {
+		// Already seen it signal
+		if(Signalled) {
+			return true;
+
+		}
+
+		// The job hasnt run yet
+		GLsync Sync = Fence.load(std::memory_order_acquire);
+		if(!Sync) {
+			return false;
+
+		}
+
+		// Polling the fence with no timeout
+		GLenum Result = glClientWaitSync(Sync, 0, 0);
+		if(Result == GL_ALREADY_SIGNALED || Result == GL_CONDITION_SATISFIED) {
+			glDeleteSync(Sync);
+			Signalled = true;
+
+		}
+
+		return Signalled;
+
+	}
+
+	/**
+	 * @brief Blocks until the job has finished on the GPU.
+	 * @note Use for teardown, not every frame, that is what IsReady() is for.
+	 */
+	void Wait() {
+		// Waiting for the loader thread to run the job
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			Condition.wait(Lock, [this]() { return Fence.load(std::memory_order_acquire) != nullptr; });
+		}
+
+		// Waiting for the GPU
+		while(!IsReady()) {
+			glClientWaitSync(Fence.load(std::memory_order_acquire), 0, 1000000);
+
+		}
+
+	}
+
+	/**
+	 * @brief Deletes the fence if it was never seen signalling.
+	 */
+	~UploadFence() {
+		GLsync Sync = Fence.load(std::memory_order_acquire);
+		if(Sync && !Signalled) {
+			glDeleteSync(Sync);
+
+		}
+
+	}
+
+private:
+	friend class LoaderInstance;
+
+	/**
+	 * @brief Publishes the fence, called by the loader after the job.
+	 * @param Sync The fence placed after the job.
+	 */
+	void Publish(GLsync Sync) {
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Fence.store(Sync, std::memory_order_release);
+		}
+		Condition.notify_all();
+
+	}
+
+	std::atomic<GLsync> Fence { nullptr };	// The fence after the job, null until the job runs
+	bool Signalled = false;					// Whether the render thread has seen the fence signal
+	std::mutex Mutex;						// Only used by Wait()
+	std::condition_variable Condition;		// Only used by Wait()
+
+};
+
+/**
+ * @class LoaderInstance
+ * @brief A thread with its own OpenGL context shared with a window, which runs upload jobs off the render thread.
+ * @note Buffers, textures and shader programs are shared between the contexts, VAOs and framebuffers are not. Anything unshared has to be made on the render thread once the fence has signalled.
+ * @note If the shared context cannot be created, jobs run right away on the calling thread instead.
+ * @warning Must be created and destroyed on the main thread, and destroyed before the WindowInstance it shares with.
+ */
+class LoaderInstance {
+public:
+	/**
+	 * @brief Constructor which creates the shared context and starts the thread.
+	 * @param _Window The window whose context the loader shares with.
+	 */
+	LoaderInstance(WindowInstance* _Window) : Window(_Window) {
+		// Guard checking
+		if(!Window || !Window->GetWindowPointer()) {
+			SR_LOG_ERROR("LoaderInstance: Constructor: Window does not exist, jobs will run on the calling thread.");
+			return;
+
+		}
+
+		// Matching the version of the window, shared contexts have to be compatible
+		int VersionMajor, VersionMinor;
+		glGetIntegerv(GL_MAJOR_VERSION, &VersionMajor);
+		glGetIntegerv(GL_MINOR_VERSION, &VersionMinor);
+
+		// Creating a hidden window for the context
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, VersionMajor);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, VersionMinor);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		SharedWindow = glfwCreateWindow(1, 1, "SimpleRenderer Loader", NULL, Window->GetWindowPointer());
+		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+		// Checking for failure
+		if(!SharedWindow) {
+			SR_LOG_ERROR("LoaderInstance: Constructor: Shared context creation failed, jobs will run on the calling thread.");
+			return;
+
+		}
+
+		// Starting the thread
+		Thread = std::thread(&LoaderInstance::Run, this);
+
+	}
+
+	/**
+	 * @brief Queues a job to run on the loader thread.
+	 * @param Job The function to run. The shared context is current while it runs.
+	 * @return Returns a shared UploadFence which says when the job is done on the GPU.
+	 * @note Whatever the job uses has to stay alive until it has run, so copy data into the job instead of pointing at it.
+	 */
+	std::shared_ptr<UploadFence> Submit(std::function<void()> Job) {
+		std::shared_ptr<UploadFence> Fence = std::make_shared<UploadFence>();
+
+		// No thread, running it right here
+		if(!SharedWindow) {
+			Job();
+			Fence->Publish(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+			return Fence;
+
+		}
+
+		// Queueing it
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Jobs.push_back({ std::move(Job), Fence });
+		}
+		Condition.notify_one();
+
+		return Fence;
+
+	}
+
+	/**
+	 * @brief Function to get the number of jobs which havent run yet.
+	 * @return Returns the number of queued jobs.
+	 */
+	int GetPendingJobCount() {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return (int)Jobs.size();
+
+	}
+
+	/**
+	 * @brief Runs every queued job, stops the thread and destroys the shared context.
+	 */
+	~LoaderInstance() {
+		// Guard checking
+		if(!SharedWindow) {
+			return;
+
+		}
+
+		// Stopping the thread, it finishes the queue first
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Stopping = true;
+		}
+		Condition.notify_one();
+		Thread.join();
+
+		// Destroying the hidden window
+		glfwDestroyWindow(SharedWindow);
+
+	}
+
+private:
+	/**
+	 * @struct LoaderJob
+	 * @brief A queued function and the fence to publish after it.
+	 */
+	struct LoaderJob {
+		std::function<void()> Function;
+		std::shared_ptr<UploadFence> Fence;
+
+	};
+
+	/**
+	 * @brief The loader thread.
+	 */
+	void Run() {
+		// Taking the shared context
+		glfwMakeContextCurrent(SharedWindow);
+
+		while(true) {
+			LoaderJob Job;
+
+			// Waiting for a job
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Condition.wait(Lock, [this]() { return Stopping || !Jobs.empty(); });
+
+				if(Jobs.empty()) {
+					break;
+
+				}
+
+				Job = std::move(Jobs.front());
+				Jobs.pop_front();
+			}
+
+			// Running it and fencing it, the flush makes sure the fence actually gets to the GPU
+			Job.Function();
+			GLsync Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			glFlush();
+
+			Job.Fence->Publish(Sync);
+
+		}
+
+		// Giving the context back
+		glfwMakeContextCurrent(NULL);
+
+	}
+
+	WindowInstance* Window = nullptr;		// The window the context is shared with
+	GLFWwindow* SharedWindow = nullptr;		// Hidden window owning the loader context
+
+	std::thread Thread;						// The loader thread
+	std::mutex Mutex;						// Protects Jobs and Stopping
+	std::condition_variable Condition;		// Wakes the thread when there is a job
+	std::deque<LoaderJob> Jobs;				// Queued jobs
+	bool Stopping = false;					// Tells the thread to finish up
+
+};
@@ -0,0 +1,420 @@
+/**
+ * @file log.h
+ * @brief Contains the logger, which keeps error printing off the render thread.
+ * @note Messages go through the SR_LOG_* macros. Each call site is rate limited on its own, so something failing every frame prints a few times a second instead of flooding the output.
+ * @note SR_LOG_UNLIMITED skips the rate limit and the queue, for reports which have to be printed in full.
+ * @note Messages are formatted into a lock free ring buffer and printed by a background thread. Nothing on the calling thread waits on the output.
+ * @note Debug messages are compiled out unless SR_LOG_MIN_LEVEL is 0. It defaults to 0 without NDEBUG and 1 (info) with it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#ifndef SR_LOG_MIN_LEVEL
+	#ifdef NDEBUG
+		#define SR_LOG_MIN_LEVEL 1
+	#else
+		#define SR_LOG_MIN_LEVEL 0
+	#endif
+#endif
+
+#ifndef SR_LOG_SITE_LIMIT
+	#define SR_LOG_SITE_LIMIT 5			// Max messages per call site per second, the rest are counted and dropped
+#endif
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a message.
+ */
+enum class LogLevel {
+	Debug = 0,
+	Info = 1,
+	Warning = 2,
+	Error = 3
+
+};
+
+/**
+ * @class LogSite
+ * @brief Rate limit state of a single SR_LOG_* call site, made as a static by the macro.
+ * @note Only atomics are touched, so checking it costs a few nanoseconds and never blocks.
+ */
+class LogSite {
+public:
+	/**
+	 * @brief Checks if the site can log right now, counting it as suppressed if not.
+	 * @return Returns a bool of whether the message should be written.
+	 */
+	bool ShouldLog() {
+		std::int64_t Now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		// Starting a new one second window
+		std::int64_t Start = WindowStart.load(std::memory_order_relaxed);
+		if(Now - Start >= 1000 && WindowStart.compare_exchange_strong(Start, Now, std::memory_order_relaxed)) {
+			Count.store(0, std::memory_order_relaxed);
+
+		}
+
+		// Letting the first few through
+		if(Count.fetch_add(1, std::memory_order_relaxed) < SR_LOG_SITE_LIMIT) {
+			return true;
+
+		}
+
+		Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+
+	}
+
+	/**
+	 * @brief Takes the number of messages suppressed since the last one that got through.
+	 * @return Returns the count, and resets it.
+	 */
+	std::uint32_t TakeSuppressed() {
+		return Suppressed.exchange(0, std::memory_order_relaxed);
+
+	}
+
+private:
+	std::atomic<std::int64_t> WindowStart { -1000 };	// Start of the current window in milliseconds
+	std::atomic<std::uint32_t> Count { 0 };			// Messages in the current window
+	std::atomic<std::uint32_t> Suppressed { 0 };		// Messages dropped since the last one written
+
+};
+
+/**
+ * @class LoggerInstance
+ * @brief The single logger, with a bounded lock free queue drained by a background thread.
+ * @note If the queue is full the message is dropped and counted, the caller never waits.
+ * @warning Messages logged after the logger is destroyed at exit are printed straight away.
+ */
+class LoggerInstance {
+public:
+	/**
+	 * @brief Gets the logger, starting it the first time.
+	 * @return Returns a reference to the logger.
+	 */
+	static LoggerInstance& Get() {
+		static LoggerInstance Logger;
+		return Logger;
+
+	}
+
+	/**
+	 * @brief Formats a message into the queue. Use the SR_LOG_* macros instead of calling this.
+	 * @param Level Severity of the message.
+	 * @param Site The call site, for its suppressed count.
+	 * @param Format printf style format string.
+	 */
+#if defined(__GNUC__) || defined(__clang__)
+	__attribute__((format(printf, 4, 5)))
+#endif
+	void Write(LogLevel Level, LogSite& Site, const char* Format, ...) {
+		// Dropping anything below the runtime level
+		if((int)Level < MinLevel.load(std::memory_order_relaxed)) {
+			return;
+
+		}
+
+		// Already shut down, printing right here
+		if(Stopped.load(std::memory_order_acquire)) {
+			char Text[MessageSize];
+			va_list Args;
+			va_start(Args, Format);
+			std::vsnprintf(Text, MessageSize, Format, Args);
+			va_end(Args);
+			std::cout << GetLevelName(Level) << ": " << Text << "\n";
+			return;
+
+		}
+
+		// Claiming a slot
+		std::size_t Position = EnqueuePosition.load(std::memory_order_relaxed);
+		Slot* Target;
+		while(true) {
+			Target = &Slots[Position % Capacity];
+			std::size_t Sequence = Target->Sequence.load(std::memory_order_acquire);
+			std::intptr_t Difference = (std::intptr_t)Sequence - (std::intptr_t)Position;
+
+			if(Difference == 0) {
+				// Free, trying to take it
+				if(EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed)) {
+					break;
+
+				}
+
+			} else if(Difference < 0) {
+				// Full, dropping the message
+				Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+
+			} else {
+				// Someone else took it, trying the next one
+				Position = EnqueuePosition.load(std::memory_order_relaxed);
+
+			}
+
+		}
+
+		// Filling it in and publishing it
+		Target->Level = Level;
+		Target->Suppressed = Site.TakeSuppressed();
+		va_list Args;
+		va_start(Args, Format);
+		std::vsnprintf(Target->Text, MessageSize, Format, Args);
+		va_end(Args);
+		Target->Sequence.store(Position + 1, std::memory_order_release);
+
+	}
+
+	/**
+	 * @brief Prints a message on the calling thread, after anything already queued. Use SR_LOG_UNLIMITED instead of calling this.
+	 * @param Level Severity of the message.
+	 * @param Format printf style format string.
+	 * @note Not rate limited and never dropped, but waits on the output, so keep it off the render loop.
+	 */
+#if defined(__GNUC__) || defined(__clang__)
+	__attribute__((format(printf, 3, 4)))
+#endif
+	void WriteNow(LogLevel Level, const char* Format, ...) {
+		// Dropping anything below the runtime level
+		if((int)Level < MinLevel.load(std::memory_order_relaxed)) {
+			return;
+
+		}
+
+		char Text[MessageSize];
+		va_list Args;
+		va_start(Args, Format);
+		std::vsnprintf(Text, MessageSize, Format, Args);
+		va_end(Args);
+
+		// Already shut down, printing right here
+		if(Stopped.load(std::memory_order_acquire)) {
+			std::cout << GetLevelName(Level) << ": " << Text << "\n";
+			return;
+
+		}
+
+		// Taking over from the background thread, printing the queue first so the order is kept
+		while(Draining.exchange(true, std::memory_order_acquire)) {
+			std::this_thread::yield();
+
+		}
+		PrintQueued();
+
+		std::ostream& Out = *Output.load(std::memory_order_acquire);
+		Out << GetLevelName(Level) << ": " << Text << "\n";
+		Out.flush();
+		Draining.store(false, std::memory_order_release);
+
+	}
+
+	/**
+	 * @brief Sets the lowest level which is written, on top of the compile time level.
+	 * @param Level The lowest level.
+	 */
+	void SetLevel(LogLevel Level) {
+		MinLevel.store((int)Level, std::memory_order_relaxed);
+
+	}
+
+	/**
+	 * @brief Sets where messages are printed.
+	 * @param _Output The stream, std::cout by default.
+	 * @warning Must stay alive until the logger is destroyed or the output is changed again.
+	 */
+	void SetOutput(std::ostream* _Output) {
+		Output.store(_Output, std::memory_order_release);
+
+	}
+
+	/**
+	 * @brief Prints everything that is queued right now, on the calling thread.
+	 */
+	void Flush() {
+		Drain();
+
+	}
+
+	/**
+	 * @brief Stops the thread and prints anything left.
+	 */
+	~LoggerInstance() {
+		Running.store(false, std::memory_order_release);
+		Thread.join();
+		Drain();
+		Stopped.store(true, std::memory_order_release);
+
+	}
+
+private:
+	static const std::size_t Capacity = 1024;		// Number of slots in the queue
+	static const int MessageSize = 256;				// Max length of a message, longer ones are cut off
+
+	/**
+	 * @struct Slot
+	 * @brief A single message in the queue.
+	 */
+	struct Slot {
+		std::atomic<std::size_t> Sequence;			// Which lap of the ring the slot is ready for
+		LogLevel Level;
+		std::uint32_t Suppressed;
+		char Text[MessageSize];
+
+	};
+
+	/**
+	 * @brief Sets up the slots and starts the thread.
+	 */
+	LoggerInstance() {
+		for(std::size_t Index = 0; Index < Capacity; Index++) {
+			Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+
+		}
+
+		Thread = std::thread(&LoggerInstance::Run, this);
+
+	}
+
+	LoggerInstance(const LoggerInstance&) = delete;
+	LoggerInstance& operator=(const LoggerInstance&) = delete;
+
+	/**
+	 * @brief The background thread, wakes up every few milliseconds to print.
+	 */
+	void Run() {
+		while(Running.load(std::memory_order_acquire)) {
+			Drain();
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+		}
+
+	}
+
+	/**
+	 * @brief Prints every ready message. Only one thread drains at a time.
+	 */
+	void Drain() {
+		// Only one consumer at a time
+		if(Draining.exchange(true, std::memory_order_acquire)) {
+			return;
+
+		}
+
+		PrintQueued();
+		Draining.store(false, std::memory_order_release);
+
+	}
+
+	/**
+	 * @brief Prints every ready message. Only call while holding Draining.
+	 */
+	void PrintQueued() {
+		std::ostream& Out = *Output.load(std::memory_order_acquire);
+
+		while(true) {
+			Slot& Source = Slots[DequeuePosition % Capacity];
+			if(Source.Sequence.load(std::memory_order_acquire) != DequeuePosition + 1) {
+				break;
+
+			}
+
+			Out << GetLevelName(Source.Level) << ": " << Source.Text;
+			if(Source.Suppressed > 0) {
+				Out << " (" << Source.Suppressed << " more like this suppressed)";
+
+			}
+			Out << "\n";
+
+			// Giving the slot back for the next lap
+			Source.Sequence.store(DequeuePosition + Capacity, std::memory_order_release);
+			DequeuePosition++;
+
+		}
+
+		// Reporting drops
+		std::uint32_t DroppedCount = Dropped.exchange(0, std::memory_order_relaxed);
+		if(DroppedCount > 0) {
+			Out << "Warning: LoggerInstance: Queue was full, " << DroppedCount << " messages dropped.\n";
+
+		}
+
+		Out.flush();
+
+	}
+
+	/**
+	 * @brief Gets the name printed before a message.
+	 */
+	static const char* GetLevelName(LogLevel Level) {
+		switch(Level) {
+			case LogLevel::Debug: return "Debug";
+			case LogLevel::Info: return "Info";
+			case LogLevel::Warning: return "Warning";
+			default: return "Error";
+
+		}
+
+	}
+
+	Slot Slots[Capacity];								// The ring
+	std::atomic<std::size_t> EnqueuePosition { 0 };		// Next position a writer claims
+	std::size_t DequeuePosition = 0;					// Next position the drain reads, only touched while Draining
+	std::atomic<std::uint32_t> Dropped { 0 };			// Messages dropped because the queue was full
+	std::atomic<int> MinLevel { SR_LOG_MIN_LEVEL };		// Runtime level
+	std::atomic<std::ostream*> Output { &std::cout };	// Where messages go
+	std::atomic<bool> Draining { false };				// Whether a thread is draining
+	std::atomic<bool> Running { true };					// Whether the thread should keep going
+	std::atomic<bool> Stopped { false };				// Whether the logger has shut down
+	std::thread Thread;									// The background thread
+
+};
+
+/**
+ * @brief Logs a message at a level, rate limited per call site. Takes a printf style format and arguments.
+ */
+#define SR_LOG(Level, ...) \
+	do { \
+		static LogSite SRLogSite; \
+		if(SRLogSite.ShouldLog()) { \
+			LoggerInstance::Get().Write(Level, SRLogSite, __VA_ARGS__); \
+		} \
+	} while(0)
+
+/**
+ * @brief Logs a message at a level straight away, with no rate limit. Takes a printf style format and arguments.
+ */
+#define SR_LOG_UNLIMITED(Level, ...) \
+	do { \
+		if((int)(Level) >= SR_LOG_MIN_LEVEL) { \
+			LoggerInstance::Get().WriteNow(Level, __VA_ARGS__); \
+		} \
+	} while(0)
+
+#if SR_LOG_MIN_LEVEL <= 0
+	#define SR_LOG_DEBUG(...) SR_LOG(LogLevel::Debug, __VA_ARGS__)
+#else
+	#define SR_LOG_DEBUG(...) do {} while(0)
+#endif
+
+#if SR_LOG_MIN_LEVEL <= 1
+	#define SR_LOG_INFO(...) SR_LOG(LogLevel::Info, __VA_ARGS__)
+#else
+	#define SR_LOG_INFO(...) do {} while(0)
+#endif
+
+#if SR_LOG_MIN_LEVEL <= 2
+	#define SR_LOG_WARNING(...) SR_LOG(LogLevel::Warning, __VA_ARGS__)
+#else
+	#define SR_LOG_WARNING(...) do {} while(0)
+#endif
+
+#define SR_LOG_ERROR(...) SR_LOG(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,478 @@
+/**
+ * @file material.h
+ * @brief Contains array textures, materials and the material batch which draws many textured objects with few binds.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+#include <SimpleRenderer/object.h>
+#include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/texture.h>
+
+/**
+ * @class TextureArrayInstance
+ * @brief A GL_TEXTURE_2D_ARRAY where every layer has the same format and size.
+ * @note Layers can also be used as atlases, a material picks a UV rect inside its layer.
+ * @warning The renderer must be initialized before creating any texture arrays.
+ */
+class TextureArrayInstance {
+public:
+	TextureArrayInstance() {}			// Default constructor
+
+	/**
+	 * @brief Constructor which makes the immutable storage for the array.
+	 * @param _Format Format every layer must have.
+	 * @param _Width Width of every layer.
+	 * @param _Height Height of every layer.
+	 * @param _LayerCapacity Max number of layers.
+	 * @param _LevelCount Number of mip levels, 0 for a full chain.
+	 */
+	TextureArrayInstance(const TextureFormat& _Format, int _Width, int _Height, int _LayerCapacity, int _LevelCount = 0) :
+		Format(_Format),
+		Width(_Width),
+		Height(_Height),
+		LayerCapacity(_LayerCapacity)
+	{
+		// Working out the level count
+		int FullLevels = TextureData::GetFullLevelCount(Width, Height);
+		LevelCount = _LevelCount <= 0 ? FullLevels : std::min(_LevelCount, FullLevels);
+
+		// Making the storage
+		glGenTextures(1, &ID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+
+		if(GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+			glTexStorage3D(GL_TEXTURE_2D_ARRAY, LevelCount, Format.InternalFormat, Width, Height, LayerCapacity);
+
+		} else {
+			int LevelWidth = Width;
+			int LevelHeight = Height;
+			for(int Level = 0; Level < LevelCount; Level++) {
+				if(Format.Compressed) {
+					glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, Level, Format.InternalFormat, LevelWidth, LevelHeight, LayerCapacity, 0, (GLsizei)(Format.GetLevelSize(LevelWidth, LevelHeight) * LayerCapacity), NULL);
+
+				} else {
+					glTexImage3D(GL_TEXTURE_2D_ARRAY, Level, Format.InternalFormat, LevelWidth, LevelHeight, LayerCapacity, 0, Format.Format, Format.Type, NULL);
+
+				}
+
+				LevelWidth = std::max(1, LevelWidth / 2);
+				LevelHeight = std::max(1, LevelHeight / 2);
+
+			}
+
+		}
+
+		// Defaults
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, LevelCount - 1);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, LevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		// Adding up the memory of every level of every layer
+		std::size_t MemorySize = 0;
+		int LevelWidth = Width;
+		int LevelHeight = Height;
+		for(int Level = 0; Level < LevelCount; Level++) {
+			MemorySize += Format.GetLevelSize(LevelWidth, LevelHeight) * LayerCapacity;
+			LevelWidth = std::max(1, LevelWidth / 2);
+			LevelHeight = std::max(1, LevelHeight / 2);
+
+		}
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Texture, ID, MemorySize, "TextureArrayInstance");
+
+		// Setting the guard
+		ArrayCreated = true;
+
+	}
+
+	/**
+	 * @brief Uploads texture data into the next free layer.
+	 * @param Data The data, which must match the format and size of the array.
+	 * @return Returns the layer index, or -1 if the data doesnt match or the array is full.
+	 * @note If the data has fewer levels than the array and is uncompressed, call GenerateMipmaps() after adding layers.
+	 */
+	int AddLayer(const TextureData& Data) {
+		// Guard checking
+		if(!ArrayCreated) {
+			SR_LOG_ERROR("TextureArrayInstance: AddLayer(): Array has not been created.");
+			return -1;
+
+		}
+
+		if(!Data.IsValid() || Data.Format.InternalFormat != Format.InternalFormat || Data.Width != Width || Data.Height != Height) {
+			SR_LOG_ERROR("TextureArrayInstance: AddLayer(): Data does not match the format or size of the array.");
+			return -1;
+
+		}
+
+		if(LayerCount >= LayerCapacity) {
+			SR_LOG_ERROR("TextureArrayInstance: AddLayer(): Array is full.");
+			return -1;
+
+		}
+
+		int Layer = LayerCount++;
+
+		// Uploading the levels both have
+		glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		int Levels = std::min(LevelCount, (int)Data.Levels.size());
+		for(int Level = 0; Level < Levels; Level++) {
+			const TextureLevel& Info = Data.Levels[Level];
+			const unsigned char* Pixels = Data.Bytes.data() + Info.Offset;
+
+			if(Format.Compressed) {
+				glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, Level, 0, 0, Layer, Info.Width, Info.Height, 1, Format.InternalFormat, (GLsizei)Info.Size, Pixels);
+
+			} else {
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, Level, 0, 0, Layer, Info.Width, Info.Height, 1, Format.Format, Format.Type, Pixels);
+
+			}
+
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+		return Layer;
+
+	}
+
+	/**
+	 * @brief Generates the mip chain of every layer from level 0.
+	 * @note Only works for uncompressed formats.
+	 */
+	void GenerateMipmaps() {
+		// Guard checking
+		if(!ArrayCreated || Format.Compressed) {
+			SR_LOG_ERROR("TextureArrayInstance: GenerateMipmaps(): Array has not been created or is compressed.");
+			return;
+
+		}
+
+		glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	}
+
+	/**
+	 * @brief Binds the array to a texture unit.
+	 * @param Unit The texture unit, starting at 0.
+	 */
+	void Bind(int Unit) {
+		glActiveTexture(GL_TEXTURE0 + Unit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+
+	}
+
+	/**
+	 * @brief Function to get the OpenGL ID of the array.
+	 * @return Returns the texture ID.
+	 */
+	unsigned int GetID() {
+		return ID;
+
+	}
+
+	/**
+	 * @brief Function to get the number of layers that have been added.
+	 * @return Returns the layer count.
+	 */
+	int GetLayerCount() {
+		return LayerCount;
+
+	}
+
+	/**
+	 * @brief Function which deletes the array.
+	 */
+	~TextureArrayInstance() {
+		// Guard checking
+		if(!ArrayCreated) {
+			return;
+
+		}
+
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Texture, ID);
+		glDeleteTextures(1, &ID);
+
+	}
+
+private:
+	unsigned int ID = 0;			// The OpenGL ID of the array
+	bool ArrayCreated = false;		// Bool guard determining whether the array has been created
+	TextureFormat Format;			// Format of every layer
+	int Width = 0;					// Width of every layer
+	int Height = 0;					// Height of every layer
+	int LevelCount = 0;				// Number of mip levels
+	int LayerCapacity = 0;			// Max number of layers
+	int LayerCount = 0;				// Number of layers added
+
+};
+
+/**
+ * @struct MaterialInstance
+ * @brief A texture picked out of a TextureArrayInstance, by layer and UV rect.
+ */
+struct MaterialInstance {
+	TextureArrayInstance* Array = nullptr;			// The array the texture lives in
+	int Layer = 0;									// The layer in the array
+	glm::vec4 UVRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);	// Offset (xy) and scale (zw) of the UVs, for atlases
+	glm::vec4 Color = glm::vec4(1.0f);				// Color multiplied with the texture
+
+};
+
+/**
+ * @class MaterialBatchInstance
+ * @brief Collects objects with materials and draws them instanced, so different textures share one draw and one program bind.
+ * @note Each draw covers every object with the same shader, mesh and texture array. Objects have the same mesh when they share its buffers through ObjectInstance::ShareMesh().
+ * @note The bind count depends on the number of arrays, not the number of textures.
+ * @note The instance attributes are turned off again after each draw, so VAOs shared by a vertex format are left as they were.
+ * @note Per instance data goes into these vertex attribute locations:
+ * - 8 to 11: mat4 model matrix
+ * - 12: vec4 UV rect, offset in xy and scale in zw
+ * - 13: vec4 color
+ * - 14: float layer
+ * @note The texture array is bound to unit 0 and the shader's "uMaterialTextures" sampler2DArray is pointed at it.
+ * @warning The renderer must be initialized before creating a material batch.
+ */
+class MaterialBatchInstance {
+public:
+	static const int ModelLocation = 8;		// First location of the model matrix, it uses 4
+	static const int UVRectLocation = 12;	// Location of the UV rect
+	static const int ColorLocation = 13;	// Location of the color
+	static const int LayerLocation = 14;	// Location of the layer
+
+	/**
+	 * @brief Constructor which makes the instance buffer.
+	 */
+	MaterialBatchInstance() {
+		glGenBuffers(1, &InstanceBuffer);
+
+	}
+
+	/**
+	 * @brief Queues an object to be drawn with a material.
+	 * @param Object The object, its mesh, shader and model matrix are used.
+	 * @param Material The material to draw it with.
+	 */
+	void Add(ObjectInstance* Object, MaterialInstance* Material) {
+		// Skipping anything that cant be drawn, CanRender prints why
+		Object->Poll();
+		if(!Object->CanRender() || !Material->Array) {
+			return;
+
+		}
+
+		// Filling in the instance
+		QueuedDraw Draw;
+		Draw.Object = Object;
+		Draw.Shader = Object->GetShader();
+		Draw.Array = Material->Array;
+		Draw.VertexBuffer = Object->GetVertexBuffer();
+		Draw.IndexBuffer = Object->GetIndexBuffer();
+		Draw.Data.Model = glm::make_mat4(Object->GetModelMatrix());
+		Draw.Data.UVRect = Material->UVRect;
+		Draw.Data.Color = Material->Color;
+		Draw.Data.Layer = (float)Material->Layer;
+
+		Draws.push_back(Draw);
+
+	}
+
+	/**
+	 * @brief Draws everything that was queued and clears the queue.
+	 * @param View The view matrix value pointer.
+	 * @param Perspective The perspective matrix value pointer.
+	 * @note Use RendererInstance.RenderMaterialBatch() instead, which passes the matrices.
+	 */
+	void Draw(const float* View, const float* Perspective) {
+		// Nothing to do
+		if(Draws.empty()) {
+			return;
+
+		}
+
+		// Grouping by shader, then texture array, then mesh, so each changes as rarely as possible
+		std::sort(Draws.begin(), Draws.end(), [](const QueuedDraw& A, const QueuedDraw& B) {
+			if(A.Shader != B.Shader) {
+				return A.Shader < B.Shader;
+			}
+			if(A.Array != B.Array) {
+				return A.Array < B.Array;
+			}
+			if(A.VertexBuffer != B.VertexBuffer) {
+				return A.VertexBuffer < B.VertexBuffer;
+			}
+			return A.IndexBuffer < B.IndexBuffer;
+
+		});
+
+		// Packing the instance data in sorted order and uploading it all at once
+		Instances.resize(Draws.size());
+		for(std::size_t Index = 0; Index < Draws.size(); Index++) {
+			Instances[Index] = Draws[Index].Data;
+
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, InstanceBuffer);
+		glBufferData(GL_ARRAY_BUFFER, Instances.size() * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, InstanceBuffer, Instances.size() * sizeof(InstanceData), "MaterialBatchInstance instances");
+		glBufferSubData(GL_ARRAY_BUFFER, 0, Instances.size() * sizeof(InstanceData), Instances.data());
+
+		ShaderInstance* CurrentShader = nullptr;
+		TextureArrayInstance* CurrentArray = nullptr;
+
+		// Drawing each run of the same shader, array and mesh
+		std::size_t First = 0;
+		while(First < Draws.size()) {
+			// Finding the end of the run
+			std::size_t Last = First + 1;
+			while(Last < Draws.size() && Draws[Last].Shader == Draws[First].Shader && Draws[Last].Array == Draws[First].Array && Draws[Last].VertexBuffer == Draws[First].VertexBuffer && Draws[Last].IndexBuffer == Draws[First].IndexBuffer) {
+				Last++;
+
+			}
+
+			const QueuedDraw& Run = Draws[First];
+
+			// Only switching program when it changes
+			if(Run.Shader != CurrentShader) {
+				CurrentShader = Run.Shader;
+				CurrentShader->UseProgram();
+				CurrentShader->UseViewMatrix(View);
+				CurrentShader->UsePerspectiveMatrix(Perspective);
+				CurrentShader->UseInt("uMaterialTextures", 0);
+
+			}
+
+			// Only switching texture when it changes
+			if(Run.Array != CurrentArray) {
+				CurrentArray = Run.Array;
+				CurrentArray->Bind(0);
+
+			}
+
+			// Pointing the mesh's instance attributes at this run
+			Run.Object->UseVAO();
+			glBindBuffer(GL_ARRAY_BUFFER, InstanceBuffer);
+			SetInstanceAttributes(First * sizeof(InstanceData));
+
+			glDrawElementsInstanced(GL_TRIANGLES, Run.Object->GetIndicesCount(), GL_UNSIGNED_INT, 0, (GLsizei)(Last - First));
+			DisableInstanceAttributes();
+
+			First = Last;
+
+		}
+
+		glBindVertexArray(0);
+
+		// Ready for the next frame
+		Draws.clear();
+
+	}
+
+	/**
+	 * @brief Function to get the number of queued objects.
+	 * @return Returns the number of objects queued since the last Draw().
+	 */
+	int GetQueuedCount() {
+		return (int)Draws.size();
+
+	}
+
+	/**
+	 * @brief Function which deletes the instance buffer.
+	 */
+	~MaterialBatchInstance() {
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, InstanceBuffer);
+		glDeleteBuffers(1, &InstanceBuffer);
+
+	}
+
+private:
+	/**
+	 * @struct InstanceData
+	 * @brief Per instance data, as laid out in the instance buffer.
+	 */
+	struct InstanceData {
+		glm::mat4 Model;
+		glm::vec4 UVRect;
+		glm::vec4 Color;
+		float Layer;
+
+	};
+
+	/**
+	 * @struct QueuedDraw
+	 * @brief An object waiting to be drawn.
+	 */
+	struct QueuedDraw {
+		ObjectInstance* Object;
+		ShaderInstance* Shader;
+		TextureArrayInstance* Array;
+		unsigned int VertexBuffer;
+		unsigned int IndexBuffer;
+		InstanceData Data;
+
+	};
+
+	/**
+	 * @brief Sets the instance attributes of the bound VAO to start at an offset in the instance buffer.
+	 * @param Offset Offset in bytes of the first instance.
+	 */
+	void SetInstanceAttributes(std::size_t Offset) {
+		// Model matrix, one vec4 column per location
+		for(int Column = 0; Column < 4; Column++) {
+			glVertexAttribPointer(ModelLocation + Column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(Offset + offsetof(InstanceData, Model) + Column * sizeof(glm::vec4)));
+			glEnableVertexAttribArray(ModelLocation + Column);
+			glVertexAttribDivisor(ModelLocation + Column, 1);
+
+		}
+
+		glVertexAttribPointer(UVRectLocation, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(Offset + offsetof(InstanceData, UVRect)));
+		glEnableVertexAttribArray(UVRectLocation);
+		glVertexAttribDivisor(UVRectLocation, 1);
+
+		glVertexAttribPointer(ColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(Offset + offsetof(InstanceData, Color)));
+		glEnableVertexAttribArray(ColorLocation);
+		glVertexAttribDivisor(ColorLocation, 1);
+
+		glVertexAttribPointer(LayerLocation, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(Offset + offsetof(InstanceData, Layer)));
+		glEnableVertexAttribArray(LayerLocation);
+		glVertexAttribDivisor(LayerLocation, 1);
+
+	}
+
+	/**
+	 * @brief Turns the instance attributes of the bound VAO back off, so later draws with it dont read the instance buffer.
+	 */
+	void DisableInstanceAttributes() {
+		for(int Location = ModelLocation; Location <= LayerLocation; Location++) {
+			glDisableVertexAttribArray(Location);
+			glVertexAttribDivisor(Location, 0);
+
+		}
+
+	}
+
+	unsigned int InstanceBuffer = 0;		// Buffer holding the per instance data
+	std::vector<QueuedDraw> Draws;			// Objects queued this frame
+	std::vector<InstanceData> Instances;	// Scratch for packing the instance data
+
+};
@@ -0,0 +1,340 @@
+/**
+ * @file memory.h
+ * @brief Contains the memory tracker, which keeps count of every buffer, texture, renderbuffer and program the library makes.
+ * @note Sizes are what the library asked for, not what the driver actually reserved. Drivers pad and may keep extra copies, so treat the totals as a lower bound.
+ * @note Program sizes are the length of the program binary, when the driver can report it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <SimpleRenderer/log.h>
+
+/**
+ * @enum MemoryCategory
+ * @brief Kinds of GPU resources that are tracked.
+ */
+enum class MemoryCategory {
+	Buffer,
+	Texture,
+	Renderbuffer,
+	Program,
+	Count
+
+};
+
+/**
+ * @struct MemoryStats
+ * @brief Totals for a category, or for everything.
+ */
+struct MemoryStats {
+	std::size_t Bytes = 0;		// Bytes currently allocated
+	std::size_t Peak = 0;		// Most bytes ever allocated at once, since the last ResetPeaks()
+	std::size_t Count = 0;		// Number of live resources
+
+};
+
+/**
+ * @class MemoryTrackerInstance
+ * @brief Keeps every live GPU resource the library made, with its size and owner.
+ * @note Thread safe, loader threads report their uploads too.
+ * @note Anything still tracked when the program exits is reported as a leak.
+ */
+class MemoryTrackerInstance {
+public:
+	/**
+	 * @brief Gets the tracker, making it the first time.
+	 * @return Returns a reference to the tracker.
+	 */
+	static MemoryTrackerInstance& Get() {
+		static MemoryTrackerInstance Tracker;
+		return Tracker;
+
+	}
+
+	/**
+	 * @brief Records an allocation, or the new size of a resource that was reallocated.
+	 * @param Category Kind of resource.
+	 * @param ID The OpenGL ID.
+	 * @param Bytes Size of the allocation.
+	 * @param Owner What made it, e.g "ObjectInstance vertices". Must be a string literal.
+	 */
+	void Track(MemoryCategory Category, unsigned int ID, std::size_t Bytes, const char* Owner) {
+		std::function<void(std::size_t, std::size_t)> Callback;
+		std::size_t Exceeded = 0;
+		std::size_t CurrentBudget = 0;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+
+			// Replacing the old size if it was already tracked
+			Entry& Current = Entries[MakeKey(Category, ID)];
+			MemoryStats& Stats = Categories[(int)Category];
+			if(Current.Owner) {
+				Stats.Bytes -= Current.Bytes;
+				Total.Bytes -= Current.Bytes;
+
+			} else {
+				Stats.Count++;
+				Total.Count++;
+
+			}
+			Current.Bytes = Bytes;
+			Current.Owner = Owner;
+
+			// Adding it up
+			std::size_t Before = Total.Bytes;
+			Stats.Bytes += Bytes;
+			Total.Bytes += Bytes;
+			Stats.Peak = std::max(Stats.Peak, Stats.Bytes);
+			Total.Peak = std::max(Total.Peak, Total.Bytes);
+
+			// Only reporting when the budget is first crossed, not on every allocation over it
+			if(Budget > 0 && Total.Bytes > Budget && Before <= Budget) {
+				Callback = BudgetCallback;
+				Exceeded = Total.Bytes;
+				CurrentBudget = Budget;
+
+			}
+
+		}
+
+		// Calling back outside the lock, so the callback can ask for stats or a dump
+		if(Exceeded > 0) {
+			SR_LOG_WARNING("MemoryTrackerInstance: Track(): GPU memory budget exceeded, %zu of %zu bytes by %s %u.", Exceeded, CurrentBudget, Owner, ID);
+			if(Callback) {
+				Callback(Exceeded, CurrentBudget);
+
+			}
+
+		}
+
+	}
+
+	/**
+	 * @brief Records a resource being deleted.
+	 * @param Category Kind of resource.
+	 * @param ID The OpenGL ID.
+	 * @note Call before the resource is deleted, while the ID still means the same thing.
+	 */
+	void Untrack(MemoryCategory Category, unsigned int ID) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+
+		auto Found = Entries.find(MakeKey(Category, ID));
+		if(Found == Entries.end()) {
+			return;
+
+		}
+
+		MemoryStats& Stats = Categories[(int)Category];
+		Stats.Bytes -= Found->second.Bytes;
+		Stats.Count--;
+		Total.Bytes -= Found->second.Bytes;
+		Total.Count--;
+		Entries.erase(Found);
+
+	}
+
+	/**
+	 * @brief Sets a budget for all tracked memory.
+	 * @param Bytes The budget, 0 turns it off.
+	 * @param Callback Called with the total and the budget when an allocation takes the total from within the budget to over it. Can be empty, a warning is logged either way.
+	 * @note Allocations while already over the budget do not report again, only the next crossing after the total drops back within it.
+	 * @note The callback runs on whichever thread made the allocation.
+	 */
+	void SetBudget(std::size_t Bytes, std::function<void(std::size_t Total, std::size_t Budget)> Callback = nullptr) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		Budget = Bytes;
+		BudgetCallback = std::move(Callback);
+
+	}
+
+	/**
+	 * @brief Function to get the budget.
+	 * @return Returns the budget in bytes, 0 if there is none.
+	 */
+	std::size_t GetBudget() {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Budget;
+
+	}
+
+	/**
+	 * @brief Function to get the totals for a category.
+	 * @param Category Kind of resource.
+	 * @return Returns the stats.
+	 */
+	MemoryStats GetStats(MemoryCategory Category) {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Categories[(int)Category];
+
+	}
+
+	/**
+	 * @brief Function to get the totals for everything.
+	 * @return Returns the stats.
+	 */
+	MemoryStats GetTotal() {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		return Total;
+
+	}
+
+	/**
+	 * @brief Sets every peak back to the current size, e.g after loading so only the peak while running is seen.
+	 */
+	void ResetPeaks() {
+		std::lock_guard<std::mutex> Lock(Mutex);
+		for(MemoryStats& Stats : Categories) {
+			Stats.Peak = Stats.Bytes;
+
+		}
+		Total.Peak = Total.Bytes;
+
+	}
+
+	/**
+	 * @brief Writes the totals and every live resource, biggest first.
+	 * @param Out Stream to write to.
+	 */
+	void Dump(std::ostream& Out = std::cout) {
+		// Copying everything out so the lock isnt held while writing
+		std::array<MemoryStats, (int)MemoryCategory::Count> CategoryStats;
+		MemoryStats TotalStats;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			CategoryStats = Categories;
+			TotalStats = Total;
+
+		}
+		std::vector<std::pair<std::uint64_t, Entry>> Sorted = GetSortedEntries();
+
+		Out << "GPU memory: " << TotalStats.Bytes << " bytes in " << TotalStats.Count << " resources, peak " << TotalStats.Peak << " bytes\n";
+		for(int Index = 0; Index < (int)MemoryCategory::Count; Index++) {
+			Out << "  " << GetCategoryName((MemoryCategory)Index) << ": " << CategoryStats[Index].Bytes << " bytes in " << CategoryStats[Index].Count << ", peak " << CategoryStats[Index].Peak << " bytes\n";
+
+		}
+		for(const auto& [Key, Current] : Sorted) {
+			Out << "  " << GetCategoryName((MemoryCategory)(Key >> 32)) << " " << (unsigned int)Key << ": " << Current.Bytes << " bytes, " << Current.Owner << "\n";
+
+		}
+
+	}
+
+	/**
+	 * @brief Function to get the name of a category.
+	 * @param Category Kind of resource.
+	 * @return Returns the name.
+	 */
+	static const char* GetCategoryName(MemoryCategory Category) {
+		switch(Category) {
+			case MemoryCategory::Buffer: return "Buffer";
+			case MemoryCategory::Texture: return "Texture";
+			case MemoryCategory::Renderbuffer: return "Renderbuffer";
+			case MemoryCategory::Program: return "Program";
+			default: return "Unknown";
+
+		}
+
+	}
+
+	/**
+	 * @brief Gets the size of a linked program's binary, as an estimate of its memory.
+	 * @param Program The program ID.
+	 * @return Returns the size in bytes, 0 if the driver cannot report it.
+	 */
+	static std::size_t GetProgramSize(unsigned int Program) {
+		if(!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+			return 0;
+
+		}
+
+		int Size = 0;
+		glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &Size);
+		return (std::size_t)std::max(Size, 0);
+
+	}
+
+	/**
+	 * @brief Reports anything still tracked as a leak.
+	 * @note Every leak is listed, the report skips the logger's rate limit.
+	 */
+	~MemoryTrackerInstance() {
+		if(Total.Count == 0) {
+			return;
+
+		}
+
+		SR_LOG_UNLIMITED(LogLevel::Warning, "MemoryTrackerInstance: %zu GPU resources (%zu bytes) were never deleted.", Total.Count, Total.Bytes);
+		for(const auto& [Key, Current] : GetSortedEntries()) {
+			SR_LOG_UNLIMITED(LogLevel::Warning, "MemoryTrackerInstance: Leaked %s %u, %zu bytes, %s.", GetCategoryName((MemoryCategory)(Key >> 32)), (unsigned int)Key, Current.Bytes, Current.Owner);
+
+		}
+
+	}
+
+private:
+	/**
+	 * @brief Makes sure the logger outlives the tracker, so leaks can be reported at exit.
+	 */
+	MemoryTrackerInstance() {
+		LoggerInstance::Get();
+
+	}
+
+	/**
+	 * @struct Entry
+	 * @brief A live resource.
+	 */
+	struct Entry {
+		std::size_t Bytes = 0;			// Size of the resource
+		const char* Owner = nullptr;	// What made it
+
+	};
+
+	/**
+	 * @brief Copies out every live resource, biggest first.
+	 * @return Returns the keys and entries.
+	 */
+	std::vector<std::pair<std::uint64_t, Entry>> GetSortedEntries() {
+		std::vector<std::pair<std::uint64_t, Entry>> Sorted;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			Sorted.assign(Entries.begin(), Entries.end());
+
+		}
+
+		std::sort(Sorted.begin(), Sorted.end(), [](const auto& First, const auto& Second) {
+			return First.second.Bytes > Second.second.Bytes;
+
+		});
+
+		return Sorted;
+
+	}
+
+	/**
+	 * @brief Packs a category and ID into a single key.
+	 */
+	static std::uint64_t MakeKey(MemoryCategory Category, unsigned int ID) {
+		return ((std::uint64_t)Category << 32) | ID;
+
+	}
+
+	std::mutex Mutex;												// Guards everything below
+	std::unordered_map<std::uint64_t, Entry> Entries;				// Every live resource
+	std::array<MemoryStats, (int)MemoryCategory::Count> Categories;	// Totals for each category
+	MemoryStats Total;												// Totals for everything
+	std::size_t Budget = 0;											// Budget in bytes, 0 is none
+	std::function<void(std::size_t, std::size_t)> BudgetCallback;	// Called when the budget is crossed
+
+};
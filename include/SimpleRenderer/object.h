@@ -5,24 +5,47 @@
 
 #pragma once
 
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #include <GL/glew.h>
 
+#include <SimpleRenderer/loader.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
 #include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/vertex.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+/**
+ * @brief Reads a whole buffer back from the GPU, e.g an object's vertices.
+ * @param Buffer OpenGL ID of the buffer.
+ * @param Data Vector the contents are put in.
+ * @note Stalls until the GPU is done with the buffer, so keep it out of the frame loop.
+ */
+inline void GetContentFromBuffer(unsigned int Buffer, std::vector<char>& Data) {
+	// Using copy read so no other binding is disturbed
+	glBindBuffer(GL_COPY_READ_BUFFER, Buffer);
+	int Size = 0;
+	glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &Size);
+	Data.resize(Size);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, Size, Data.data());
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	
+}
+
 /**
  * @class ObjectInstance
  * @brief Stores all data needed for rendering.
  * @todo Implement a system of static vs dynamic memory for GPU.
- * @todo Overload CreateVAO to support vectors and maybe even more data types.
+ * @todo Overload CreateVAO to support vectors.
  * @warning ShaderInstance must be created manually.
  * @warning The renderer must be initialized before creating any VAOs.
- * @todo For CanRender, print an error message or smth but not every frame
  * @todo Maybe add some identifiers so objects can be identified in errors
  */ 
 class ObjectInstance {
@@ -69,7 +92,7 @@ public:
 	void GenerateMatrix() {
 		// Checking if vector data is present
 		if(!HasWorldData) {
-			std::cout << "Error: ObjectInstance: GenerateMatrix(): No vector data present.\n";
+			SR_LOG_ERROR("ObjectInstance: GenerateMatrix(): No vector data present.");
 			return;
 		}
 		
@@ -102,8 +125,86 @@ public:
 	 * @warning Please dont put a random number in, it will cause like crazy undefined behavior.
 	 */
 	void CreateVAO(glm::vec3* VerticesPointer, int VerticesCount, unsigned int* IndicesPointer, int _IndicesCount) {
-		// Initializing IndicesCount
+		CreateVAO<PositionVertexFormat>(VerticesPointer, VerticesCount, IndicesPointer, _IndicesCount);
+		
+	}
+	
+	/**
+	 * @brief Method that creates the VAO from interleaved vertices of any format.
+	 * @tparam Format The VertexFormat of the vertices.
+	 * @param VerticesPointer Pointer to the vertices.
+	 * @param VerticesCount Number of vertices. 
+	 * @param IndicesPointer Pointer to the indices. Expects indices to be composed of unsigned ints.
+	 * @param _IndicesCount Number of indices.
+	 * @note Uses the VAO shared by the format if the context supports it, otherwise makes one for this object.
+	 */
+	template<typename Format>
+	void CreateVAO(const typename Format::VertexType* VerticesPointer, int VerticesCount, unsigned int* IndicesPointer, int _IndicesCount) {
+		// Freeing the buffers of an earlier call instead of leaking them
+		ReleaseBuffers("CreateVAO()");
+		
+		// Initializing IndicesCount and the layout
+		IndicesCount = _IndicesCount;
+		Layout = Format::Layout;
+		LayoutCount = Format::AttributeCount;
+		VertexStride = Format::Stride;
+		
+		// Creating vertex buffer object
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, VerticesCount * sizeof(typename Format::VertexType), VerticesPointer, GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, VBO, VerticesCount * sizeof(typename Format::VertexType), "ObjectInstance vertices");
+		
+		if(Format::SupportsSharedVAO()) {
+			// Using the format's VAO, the buffers get bound to it in UseVAO
+			VAO = Format::GetSharedVAO();
+			OwnsVAO = false;
+			glBindVertexArray(VAO);
+			
+		} else {
+			// Creating vertex array object with the attributes pointing into the buffer
+			glGenVertexArrays(1, &VAO);
+			glBindVertexArray(VAO);
+			Format::SetupPointers();
+			OwnsVAO = true;
+			
+		}
+		
+		// Creating index buffer object
+		glGenBuffers(1, &IBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndicesCount * sizeof(unsigned int), IndicesPointer, GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, IBO, IndicesCount * sizeof(unsigned int), "ObjectInstance indices");
+		
+		glBindVertexArray(0);
+		
+		// Setting the guard to true.
+		MeshGeneration = NextMeshGeneration();
+		HasVertexData = true;
+		
+	}
+	
+	/**
+	 * @brief Method that creates the VAO from a layout only known while running, e.g one read from a capture.
+	 * @param VerticesPointer Pointer to the interleaved vertices.
+	 * @param VerticesCount Number of vertices.
+	 * @param Stride Size of a vertex in bytes.
+	 * @param _Layout Pointer to the attributes, which must outlive the object.
+	 * @param _LayoutCount Number of attributes.
+	 * @param IndicesPointer Pointer to the indices. Expects indices to be composed of unsigned ints.
+	 * @param _IndicesCount Number of indices.
+	 * @note Always makes a VAO for this object. Use the templated CreateVAO when the format is known at compile time.
+	 */
+	void CreateVAO(const void* VerticesPointer, int VerticesCount, int Stride, const VertexAttributeLayout* _Layout, int _LayoutCount, unsigned int* IndicesPointer, int _IndicesCount) {
+		// Freeing the buffers of an earlier call instead of leaking them
+		ReleaseBuffers("CreateVAO()");
+		
+		// Initializing IndicesCount and the layout
 		IndicesCount = _IndicesCount;
+		Layout = _Layout;
+		LayoutCount = _LayoutCount;
+		VertexStride = Stride;
+		OwnsVAO = true;
 		
 		// Creating vertex array object
 		glGenVertexArrays(1, &VAO);
@@ -112,27 +213,144 @@ public:
 		// Creating vertex buffer object
 		glGenBuffers(1, &VBO);
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, VerticesCount * sizeof(glm::vec3), VerticesPointer, GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, (std::size_t)VerticesCount * Stride, VerticesPointer, GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, VBO, (std::size_t)VerticesCount * Stride, "ObjectInstance vertices");
 		
 		// Creating index buffer object
 		glGenBuffers(1, &IBO);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndicesCount * sizeof(unsigned int), IndicesPointer, GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, IBO, IndicesCount * sizeof(unsigned int), "ObjectInstance indices");
 		
 		// Vertex attributes
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0);
-		glEnableVertexAttribArray(0);
+		for(int Index = 0; Index < LayoutCount; Index++) {
+			const VertexAttributeLayout& Attribute = Layout[Index];
+			glEnableVertexAttribArray(Attribute.Location);
+			if(Attribute.Integer) {
+				glVertexAttribIPointer(Attribute.Location, Attribute.Components, Attribute.Type, Stride, (void*)Attribute.Offset);
+				
+			} else {
+				glVertexAttribPointer(Attribute.Location, Attribute.Components, Attribute.Type, Attribute.Normalized ? GL_TRUE : GL_FALSE, Stride, (void*)Attribute.Offset);
+				
+			}
+			
+		}
 		
-		// Deleting buffers, not needed because of VAO
 		glBindVertexArray(0);
-		//glDeleteBuffers(1, &VBO);
-		//glDeleteBuffers(1, &IBO);
 		
 		// Setting the guard to true.
+		MeshGeneration = NextMeshGeneration();
 		HasVertexData = true;
 		
 	}
 	
+	/**
+	 * @brief Method that makes the object draw another object's mesh, without copying its buffers.
+	 * @param Source The object which owns the mesh. Must have its vertex data, and must outlive this object.
+	 * @note Objects sharing a mesh have the same vertex and index buffers, so a MaterialBatchInstance draws them in one instanced draw.
+	 */
+	void ShareMesh(ObjectInstance* Source) {
+		// Guard checking
+		Source->Poll();
+		if(!Source->HasVertexData) {
+			SR_LOG_ERROR("ObjectInstance: ShareMesh(): Source object has no vertex data.");
+			return;
+			
+		}
+		
+		// Freeing the buffers of an earlier call instead of leaking them
+		ReleaseBuffers("ShareMesh()");
+		
+		// Taking everything about the mesh
+		VAO = Source->VAO;
+		VBO = Source->VBO;
+		IBO = Source->IBO;
+		IndicesCount = Source->IndicesCount;
+		OwnsVAO = Source->OwnsVAO;
+		Layout = Source->Layout;
+		LayoutCount = Source->LayoutCount;
+		VertexStride = Source->VertexStride;
+		MeshGeneration = Source->MeshGeneration;
+		OwnsBuffers = false;
+		
+		// Setting the guard to true.
+		HasVertexData = true;
+		
+	}
+	
+	/**
+	 * @brief Method that uploads the vertex and index buffers on a loader thread instead of the render thread.
+	 * @param Loader Pointer to the loader which does the upload.
+	 * @param VerticesPointer Pointer to the vertices. Expects vertices to be composed of glm::vec3s.
+	 * @param VerticesCount Number of vertices. 
+	 * @param IndicesPointer Pointer to the indices. Expects indices to be composed of unsigned ints.
+	 * @param _IndicesCount Number of indices.
+	 * @note The data is copied, so it can be freed right after this returns.
+	 * @note The object does not render until the upload fence has signalled. Poll() makes the VAO on the render thread then, since VAOs are not shared between contexts.
+	 */
+	void CreateVAOAsync(LoaderInstance* Loader, glm::vec3* VerticesPointer, int VerticesCount, unsigned int* IndicesPointer, int _IndicesCount) {
+		// Freeing the buffers of an earlier call instead of leaking them
+		ReleaseBuffers("CreateVAOAsync()");
+		
+		// Initializing IndicesCount and the layout, FinishUpload makes a VAO of vec3 positions for this object
+		IndicesCount = _IndicesCount;
+		Layout = PositionVertexFormat::Layout;
+		LayoutCount = PositionVertexFormat::AttributeCount;
+		VertexStride = PositionVertexFormat::Stride;
+		OwnsVAO = true;
+		
+		// Copying the data so the caller doesnt have to keep it around
+		std::shared_ptr<PendingBuffers> Pending = std::make_shared<PendingBuffers>();
+		Pending->Vertices.assign(VerticesPointer, VerticesPointer + VerticesCount);
+		Pending->Indices.assign(IndicesPointer, IndicesPointer + IndicesCount);
+		
+		// Uploading on the loader thread, copy write is used since element buffers need a VAO to bind in core profile
+		Upload = Loader->Submit([Pending]() {
+			glGenBuffers(1, &Pending->VBO);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, Pending->VBO);
+			glBufferData(GL_COPY_WRITE_BUFFER, Pending->Vertices.size() * sizeof(glm::vec3), Pending->Vertices.data(), GL_STATIC_DRAW);
+			MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Pending->VBO, Pending->Vertices.size() * sizeof(glm::vec3), "ObjectInstance vertices");
+			
+			glGenBuffers(1, &Pending->IBO);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, Pending->IBO);
+			glBufferData(GL_COPY_WRITE_BUFFER, Pending->Indices.size() * sizeof(unsigned int), Pending->Indices.data(), GL_STATIC_DRAW);
+			MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Pending->IBO, Pending->Indices.size() * sizeof(unsigned int), "ObjectInstance indices");
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+			
+			// Freeing the copies
+			Pending->Vertices = std::vector<glm::vec3>();
+			Pending->Indices = std::vector<unsigned int>();
+			
+		});
+		UploadBuffers = Pending;
+		
+	}
+	
+	/**
+	 * @brief Function which checks if an upload from CreateVAOAsync is still in flight.
+	 * @return Returns a bool of whether the object is waiting on the loader, or on Poll() to finish it.
+	 */
+	bool IsUploadPending() {
+		return Upload != nullptr;
+		
+	}
+	
+	/**
+	 * @brief Finishes an upload from CreateVAOAsync by making the VAO, if the loader is done with it.
+	 * @note RenderObject calls this before drawing. Call it before handing the object to anything else that reads its buffers, like a batch.
+	 * @warning Must be called on the render thread.
+	 */
+	void Poll() {
+		// Nothing in flight, or still going
+		if(!Upload || !Upload->IsReady()) {
+			return;
+			
+		}
+		
+		FinishUpload();
+		
+	}
+	
 	/**
 	 * @brief Function which uses the VAO.
 	 * @warning if CreateVAO has not been called, this function will not do anything and will print an error.
@@ -140,13 +358,20 @@ public:
 	void UseVAO() {
 		// Guard checking
 		if(!HasVertexData) {
-			std::cout << "Error: ObjectInstance: UseVAO(): VAO is not present.\n";
+			SR_LOG_ERROR("ObjectInstance: UseVAO(): VAO is not present.");
 			return;
 		}
 		
 		// Using VAO
 		glBindVertexArray(VAO);
 		
+		// Shared VAOs only hold the format, pointing them at this object's buffers
+		if(!OwnsVAO) {
+			glBindVertexBuffer(0, VBO, 0, VertexStride);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+			
+		}
+		
 	}
 	
 	/** 
@@ -157,7 +382,7 @@ public:
 	ShaderInstance* GetShader() {
 		// Guard checking
 		if(!HasShader) {
-			std::cout << "Error: ObjectInstance: GetShader(): Shader is not present.\n";
+			SR_LOG_ERROR("ObjectInstance: GetShader(): Shader is not present.");
 			return nullptr;
 			
 		}
@@ -175,7 +400,7 @@ public:
 	const float* GetModelMatrix() {
 		// Guard checking
 		if(!HasModelMatrix) {
-			std::cout << "Error: ObjectInstance: GetModelMatrix(): Model matrix is not present.\n";
+			SR_LOG_ERROR("ObjectInstance: GetModelMatrix(): Model matrix is not present.");
 			glm::mat4 Identity = glm::mat4(1.0f);
 			return glm::value_ptr(Identity);
 		}
@@ -185,17 +410,103 @@ public:
 		
 	}
 	
+	/**
+	 * @brief Sets the model matrix straight, instead of making it from scale, rotation and position.
+	 * @param Matrix Pointer to 16 floats in column major order.
+	 * @note Used for replaying captures, where only the matrix is known.
+	 */
+	void SetModelMatrix(const float* Matrix) {
+		Model = glm::make_mat4(Matrix);
+		
+		// Setting guards to true
+		HasWorldData = true;
+		HasModelMatrix = true;
+		
+	}
+	
+	/**
+	 * @brief Function to get the vertex buffer.
+	 * @return Returns the OpenGL ID of the vertex buffer, 0 if there is no vertex data.
+	 */
+	unsigned int GetVertexBuffer() {
+		return HasVertexData ? VBO : 0;
+		
+	}
+	
+	/**
+	 * @brief Function to get the index buffer.
+	 * @return Returns the OpenGL ID of the index buffer, 0 if there is no vertex data.
+	 */
+	unsigned int GetIndexBuffer() {
+		return HasVertexData ? IBO : 0;
+		
+	}
+	
+	/**
+	 * @brief Function to get the generation of the mesh, which tells uploads apart even when GL reuses buffer names.
+	 * @return Returns an ID unique to each upload and shared by objects sharing the mesh, 0 if there is no vertex data.
+	 */
+	std::uint64_t GetMeshGeneration() {
+		return HasVertexData ? MeshGeneration : 0;
+		
+	}
+	
+	/**
+	 * @brief Function to get the vertex layout.
+	 * @return Returns a pointer to the attributes, GetVertexLayoutCount() long.
+	 */
+	const VertexAttributeLayout* GetVertexLayout() {
+		return Layout;
+		
+	}
+	
+	/**
+	 * @brief Function to get the number of vertex attributes.
+	 * @return Returns the number of attributes in GetVertexLayout().
+	 */
+	int GetVertexLayoutCount() {
+		return LayoutCount;
+		
+	}
+	
+	/**
+	 * @brief Function to get the size of a vertex.
+	 * @return Returns the stride in bytes.
+	 */
+	int GetVertexStride() {
+		return VertexStride;
+		
+	}
+	
+	/**
+	 * @brief Function which checks if the vertices are laid out a certain way.
+	 * @param _Layout Pointer to the attributes to compare against.
+	 * @param _LayoutCount Number of attributes.
+	 * @param Stride Size of a vertex in bytes.
+	 * @return Returns a bool of whether the attributes and stride all match.
+	 */
+	bool HasVertexLayout(const VertexAttributeLayout* _Layout, int _LayoutCount, int Stride) {
+		return VertexStride == Stride && LayoutCount == _LayoutCount && std::equal(Layout, Layout + LayoutCount, _Layout);
+		
+	}
+	
 	/**
 	 * @brief Function for checking whether or not the object is renderable.
 	 * @return Returns a bool representing whether or not the object is renderable.
 	 */
 	bool CanRender() {
+		// Waiting on the loader isnt an error, just not ready yet
+		if(Upload || (HasShader && !Shader->IsReady())) {
+			return false;
+			
+		}
+		
 		// Checking guards
 		if(HasShader && HasVertexData && HasWorldData) {
 			return true;
 			
 		} else {
-			std::cout << "Error: ObjectInstance: CanRender(): Cannot render because object does not have either shader, vertex data, or world data.\n";
+			SR_LOG_ERROR("ObjectInstance: CanRender(): Cannot render because object does not have either shader, vertex data, or world data.");
 			return false;
 			
 		}
@@ -215,26 +526,146 @@ public:
 	 * @brief Function which deletes all OpenGL data associated with the program.
 	 */
 	~ObjectInstance() {
+		// Deleting the buffers of an upload that never got its VAO
+		if(Upload) {
+			DiscardUpload();
+			return;
+			
+		}
+		
 		// Guard checking
 		if(!HasVertexData) {
-			std::cout << "Error: ObjectInstance: Deconstructor: Buffers cannot be deleted because data is not present.\n";
+			SR_LOG_WARNING("ObjectInstance: Deconstructor: Object never had vertex data, nothing to delete.");
 			return;
 		}
 		
-		// Deleting data
-		glDeleteVertexArrays(1, &VAO);
-		glDeleteBuffers(1, &VBO);
-		glDeleteBuffers(1, &IBO);
+		ReleaseBuffers(nullptr);
 		
 	}
 	
 private:
+	/**
+	 * @struct PendingBuffers
+	 * @brief Data handed to the loader thread by CreateVAOAsync, and the buffers it makes.
+	 */
+	struct PendingBuffers {
+		std::vector<glm::vec3> Vertices;
+		std::vector<unsigned int> Indices;
+		unsigned int VBO = 0;
+		unsigned int IBO = 0;
+		
+	};
+	
+	/**
+	 * @brief Makes a new mesh generation.
+	 * @return Returns an ID no earlier upload had, starting at 1.
+	 */
+	static std::uint64_t NextMeshGeneration() {
+		static std::uint64_t Generation = 0;
+		return ++Generation;
+		
+	}
+	
+	/**
+	 * @brief Deletes the buffers and VAO, if there are any.
+	 * @param Caller Name of the method replacing the data, for the warning. nullptr when destroying.
+	 */
+	void ReleaseBuffers(const char* Caller) {
+		// Deleting the buffers of an upload that never got its VAO
+		if(Upload) {
+			if(Caller) {
+				SR_LOG_WARNING("ObjectInstance: %s: Object still has an upload in flight, its buffers are deleted.", Caller);
+				
+			}
+			DiscardUpload();
+			
+		}
+		
+		if(!HasVertexData) {
+			return;
+			
+		}
+		
+		if(Caller) {
+			SR_LOG_WARNING("ObjectInstance: %s: Object already has vertex data, the old buffers are deleted.", Caller);
+			
+		}
+		
+		// Deleting data, shared VAOs belong to the format and shared meshes to their source
+		if(OwnsBuffers) {
+			if(OwnsVAO) {
+				glDeleteVertexArrays(1, &VAO);
+				
+			}
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, VBO);
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, IBO);
+			glDeleteBuffers(1, &VBO);
+			glDeleteBuffers(1, &IBO);
+			
+		}
+		OwnsBuffers = true;
+		HasVertexData = false;
+		
+	}
+	
+	/**
+	 * @brief Waits out an upload from the loader and deletes its buffers, without making a VAO.
+	 */
+	void DiscardUpload() {
+		Upload->Wait();
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, UploadBuffers->VBO);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, UploadBuffers->IBO);
+		glDeleteBuffers(1, &UploadBuffers->VBO);
+		glDeleteBuffers(1, &UploadBuffers->IBO);
+		UploadBuffers.reset();
+		Upload.reset();
+		
+	}
+	
+	/**
+	 * @brief Makes the VAO around the buffers from the loader, on the render thread.
+	 */
+	void FinishUpload() {
+		// Taking the buffers
+		VBO = UploadBuffers->VBO;
+		IBO = UploadBuffers->IBO;
+		UploadBuffers.reset();
+		Upload.reset();
+		
+		// Creating vertex array object
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+		
+		// Vertex attributes
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0);
+		glEnableVertexAttribArray(0);
+		
+		glBindVertexArray(0);
+		
+		// Setting the guard to true.
+		MeshGeneration = NextMeshGeneration();
+		HasVertexData = true;
+		
+	}
+	
 	unsigned int VAO;			// Unsigned int storing the Vertex Array Object ID.
 	unsigned int VBO, IBO;		// Buffers
 	int IndicesCount;  			// Int storing the number of indices for the object.
+	bool OwnsVAO = true;		// Whether the VAO was made for this object, false if it is shared by the vertex format
+	bool OwnsBuffers = true;	// Whether the buffers and VAO belong to this object, false if the mesh is shared with ShareMesh()
+	std::uint64_t MeshGeneration = 0;	// ID of the upload the buffers came from, copied by ShareMesh()
+	
+	const VertexAttributeLayout* Layout = PositionVertexFormat::Layout;	// Attributes of the vertices
+	int LayoutCount = PositionVertexFormat::AttributeCount;				// Number of attributes
+	int VertexStride = PositionVertexFormat::Stride;					// Size of a vertex in bytes
 	
 	ShaderInstance* Shader;		// ShaderInstance pointer storing the address of the shader to be used on the object.
 	
+	std::shared_ptr<UploadFence> Upload;			// Fence of the CreateVAOAsync upload, null when nothing is in flight
+	std::shared_ptr<PendingBuffers> UploadBuffers;	// Buffers made by the CreateVAOAsync upload
+	
 	bool HasShader = false;		// Bool guard determining whether or not the class has a shader.
 	bool HasVertexData = false;	// Bool guard determining whether or not the VAO and IndicesCount have been created/initialized.
 	bool HasWorldData = false;	// Bool guard determining whether or not vector data is present.
@@ -0,0 +1,503 @@
+/**
+ * @file readback.h
+ * @brief Contains the framebuffer readback, which copies finished frames to the CPU without stalling, and PNG/raw writers for them.
+ * @note glReadPixels into a pixel buffer object returns right away, the copy happens on the GPU. The buffer is only mapped a few frames later once its fence has signalled, so the CPU never waits on the GPU.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+
+/**
+ * @struct ReadbackFrame
+ * @brief A frame read back from the GPU.
+ * @note Pixels are RGBA8 with the bottom row first, as OpenGL gives them.
+ */
+struct ReadbackFrame {
+	const unsigned char* Pixels = nullptr;	// Width * Height * 4 bytes, only valid during the callback
+	int Width = 0;							// Width in pixels
+	int Height = 0;							// Height in pixels
+	std::uint64_t Frame = 0;				// Number of the frame, counting every ReadFrame() call
+
+};
+
+/**
+ * @brief Writes a frame as raw RGBA8, top row first.
+ * @param Path Path of the file to write.
+ * @param Frame The frame.
+ * @return Returns a bool of whether the file was written.
+ */
+inline bool WriteRaw(const std::string& Path, const ReadbackFrame& Frame) {
+	std::FILE* File = std::fopen(Path.c_str(), "wb");
+	if(!File) {
+		SR_LOG_ERROR("WriteRaw: %s could not be opened.", Path.c_str());
+		return false;
+
+	}
+
+	// Flipping the rows so the top is first like every other image
+	std::size_t RowSize = (std::size_t)Frame.Width * 4;
+	for(int Row = Frame.Height - 1; Row >= 0; Row--) {
+		std::fwrite(Frame.Pixels + Row * RowSize, 1, RowSize, File);
+
+	}
+
+	std::fclose(File);
+	return true;
+
+}
+
+/**
+ * @brief Writes a frame as a PNG.
+ * @param Path Path of the file to write.
+ * @param Frame The frame.
+ * @return Returns a bool of whether the file was written.
+ * @note The image data is stored, not compressed, so writing is about as fast as WriteRaw. Files are a bit bigger than raw.
+ */
+inline bool WritePNG(const std::string& Path, const ReadbackFrame& Frame) {
+	// CRC table, made once
+	static const std::vector<std::uint32_t> CRCTable = []() {
+		std::vector<std::uint32_t> Table(256);
+		for(std::uint32_t Index = 0; Index < 256; Index++) {
+			std::uint32_t Value = Index;
+			for(int Bit = 0; Bit < 8; Bit++) {
+				Value = (Value & 1) ? 0xEDB88320u ^ (Value >> 1) : Value >> 1;
+
+			}
+			Table[Index] = Value;
+
+		}
+		return Table;
+
+	}();
+
+	std::vector<unsigned char> Out;
+	auto Put32 = [&Out](std::uint32_t Value) {
+		unsigned char Bytes[4] = { (unsigned char)(Value >> 24), (unsigned char)(Value >> 16), (unsigned char)(Value >> 8), (unsigned char)Value };
+		Out.insert(Out.end(), Bytes, Bytes + 4);
+
+	};
+
+	// Writes a chunk with its length and CRC
+	auto PutChunk = [&Out, &Put32](const char* Type, const std::vector<unsigned char>& Data) {
+		Put32((std::uint32_t)Data.size());
+		std::size_t Start = Out.size();
+		Out.insert(Out.end(), Type, Type + 4);
+		Out.insert(Out.end(), Data.begin(), Data.end());
+
+		std::uint32_t CRC = 0xFFFFFFFFu;
+		for(std::size_t Index = Start; Index < Out.size(); Index++) {
+			CRC = CRCTable[(CRC ^ Out[Index]) & 0xFF] ^ (CRC >> 8);
+
+		}
+		Put32(CRC ^ 0xFFFFFFFFu);
+
+	};
+
+	// Signature
+	const unsigned char Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	Out.insert(Out.end(), Signature, Signature + 8);
+
+	// Header, 8 bit RGBA
+	std::vector<unsigned char> Header = {
+		(unsigned char)(Frame.Width >> 24), (unsigned char)(Frame.Width >> 16), (unsigned char)(Frame.Width >> 8), (unsigned char)Frame.Width,
+		(unsigned char)(Frame.Height >> 24), (unsigned char)(Frame.Height >> 16), (unsigned char)(Frame.Height >> 8), (unsigned char)Frame.Height,
+		8, 6, 0, 0, 0
+	};
+	PutChunk("IHDR", Header);
+
+	// Rows top first, each with filter type 0
+	std::size_t RowSize = (std::size_t)Frame.Width * 4;
+	std::vector<unsigned char> Raw;
+	Raw.reserve((RowSize + 1) * Frame.Height);
+	for(int Row = Frame.Height - 1; Row >= 0; Row--) {
+		Raw.push_back(0);
+		Raw.insert(Raw.end(), Frame.Pixels + Row * RowSize, Frame.Pixels + (Row + 1) * RowSize);
+
+	}
+
+	// Zlib stream made of stored deflate blocks
+	std::vector<unsigned char> Deflate = { 0x78, 0x01 };
+	Deflate.reserve(Raw.size() + Raw.size() / 65535 * 5 + 16);
+	std::size_t Position = 0;
+	do {
+		std::size_t Length = std::min<std::size_t>(Raw.size() - Position, 65535);
+		bool Final = Position + Length == Raw.size();
+		Deflate.push_back(Final ? 1 : 0);
+		Deflate.push_back((unsigned char)Length);
+		Deflate.push_back((unsigned char)(Length >> 8));
+		Deflate.push_back((unsigned char)~Length);
+		Deflate.push_back((unsigned char)(~Length >> 8));
+		Deflate.insert(Deflate.end(), Raw.begin() + Position, Raw.begin() + Position + Length);
+		Position += Length;
+
+	} while(Position < Raw.size());
+
+	// Adler32 of the uncompressed data
+	std::uint32_t A = 1, B = 0;
+	for(unsigned char Byte : Raw) {
+		A = (A + Byte) % 65521;
+		B = (B + A) % 65521;
+
+	}
+	std::uint32_t Adler = (B << 16) | A;
+	unsigned char AdlerBytes[4] = { (unsigned char)(Adler >> 24), (unsigned char)(Adler >> 16), (unsigned char)(Adler >> 8), (unsigned char)Adler };
+	Deflate.insert(Deflate.end(), AdlerBytes, AdlerBytes + 4);
+
+	PutChunk("IDAT", Deflate);
+	PutChunk("IEND", std::vector<unsigned char>());
+
+	// Writing it out
+	std::FILE* File = std::fopen(Path.c_str(), "wb");
+	if(!File) {
+		SR_LOG_ERROR("WritePNG: %s could not be opened.", Path.c_str());
+		return false;
+
+	}
+	std::fwrite(Out.data(), 1, Out.size(), File);
+	std::fclose(File);
+	return true;
+
+}
+
+/**
+ * @class ReadbackInstance
+ * @brief Reads every frame back through a ring of pixel buffer objects and hands them to a callback a few frames later.
+ * @note Give it to RendererInstance.SetReadback(), which reads the frame just before it is swapped.
+ * @note If every buffer in the ring is still in flight the frame is skipped and counted, instead of waiting on the GPU.
+ * @note With a worker, the pixels are copied out of the mapped buffer and the callback runs on the worker thread, so slow work like writing files stays off the render thread.
+ * @note The worker queue holds at most as many frames as the ring. While it is full, finished frames stay in their buffers, so the ring fills up and new frames are skipped instead of memory growing.
+ * @warning Must be made and destroyed on the render thread, while the context is current.
+ */
+class ReadbackInstance {
+public:
+	ReadbackInstance() {}		// Default constructor
+
+	/**
+	 * @brief Constructor which makes the ring.
+	 * @param _Callback Called with every frame that is read back.
+	 * @param UseWorker Whether to call the callback on a worker thread instead of the render thread.
+	 * @param _RingSize Number of pixel buffers, i.e how many frames can be in flight.
+	 */
+	ReadbackInstance(std::function<void(const ReadbackFrame&)> _Callback, bool UseWorker = false, int _RingSize = 4) : Callback(std::move(_Callback)) {
+		// Making the ring, the buffers get their size on the first frame
+		Slots.resize(std::max(_RingSize, 2));
+		for(Slot& Current : Slots) {
+			glGenBuffers(1, &Current.Buffer);
+
+		}
+		HasBuffers = true;
+
+		// Starting the worker
+		if(UseWorker) {
+			Thread = std::thread(&ReadbackInstance::Run, this);
+			HasWorker = true;
+
+		}
+
+	}
+
+	/**
+	 * @brief Starts reading back the bound read framebuffer, and hands over any earlier frames that are done.
+	 * @param Width Width of the area to read, from the bottom left.
+	 * @param Height Height of the area to read, from the bottom left.
+	 * @note Called by RendererInstance.FinishFrame().
+	 */
+	void ReadFrame(int Width, int Height) {
+		if(!HasBuffers || Width <= 0 || Height <= 0) {
+			return;
+
+		}
+
+		// Handing over whatever has finished
+		Poll(false);
+
+		// Skipping the frame if the next slot is still in flight
+		Slot& Target = Slots[Head];
+		if(Target.Fence) {
+			Skipped++;
+			FrameCount++;
+			return;
+
+		}
+
+		// Resizing the buffer if the window changed
+		std::size_t Size = (std::size_t)Width * Height * 4;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, Target.Buffer);
+		if(Target.Size != Size) {
+			glBufferData(GL_PIXEL_PACK_BUFFER, Size, nullptr, GL_STREAM_READ);
+			MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, Target.Buffer, Size, "ReadbackInstance pixel buffer");
+			Target.Size = Size;
+
+		}
+
+		// Copying into the buffer, this returns right away
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		// Fencing it
+		Target.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		Target.Width = Width;
+		Target.Height = Height;
+		Target.Frame = FrameCount++;
+
+		Head = (Head + 1) % Slots.size();
+
+	}
+
+	/**
+	 * @brief Waits for every frame in flight and hands them over.
+	 * @note Also waits for the worker to finish its queue.
+	 */
+	void Flush() {
+		if(!HasBuffers) {
+			return;
+
+		}
+
+		Poll(true);
+
+		// Waiting for the worker to empty its queue
+		if(HasWorker) {
+			std::unique_lock<std::mutex> Lock(Mutex);
+			Idle.wait(Lock, [this]() { return Jobs.empty() && !Busy; });
+
+		}
+
+	}
+
+	/**
+	 * @brief Function to get the number of frames skipped because the ring was full.
+	 * @return Returns the skipped frame count.
+	 */
+	std::uint64_t GetSkippedCount() {
+		return Skipped;
+
+	}
+
+	/**
+	 * @brief Function to get the number of frames handed to the callback.
+	 * @return Returns the delivered frame count.
+	 */
+	std::uint64_t GetDeliveredCount() {
+		return Delivered;
+
+	}
+
+	/**
+	 * @brief Hands over the frames in flight, stops the worker and deletes the buffers.
+	 */
+	~ReadbackInstance() {
+		if(!HasBuffers) {
+			return;
+
+		}
+
+		Flush();
+
+		// Stopping the worker
+		if(HasWorker) {
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Stopping = true;
+			}
+			Condition.notify_one();
+			Thread.join();
+
+		}
+
+		for(Slot& Current : Slots) {
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, Current.Buffer);
+			glDeleteBuffers(1, &Current.Buffer);
+
+		}
+
+	}
+
+private:
+	/**
+	 * @struct Slot
+	 * @brief A single pixel buffer in the ring.
+	 */
+	struct Slot {
+		unsigned int Buffer = 0;			// The pixel buffer object
+		std::size_t Size = 0;				// Allocated size of the buffer in bytes
+		GLsync Fence = nullptr;				// Fence after the read, null when the slot is free
+		int Width = 0, Height = 0;			// Size of the frame in the buffer
+		std::uint64_t Frame = 0;			// Number of the frame in the buffer
+
+	};
+
+	/**
+	 * @struct ReadbackJob
+	 * @brief A frame copied out for the worker.
+	 */
+	struct ReadbackJob {
+		std::vector<unsigned char> Pixels;
+		int Width = 0, Height = 0;
+		std::uint64_t Frame = 0;
+
+	};
+
+	/**
+	 * @brief Hands over finished frames, oldest first.
+	 * @param Wait Whether to wait for frames that are not done yet.
+	 */
+	void Poll(bool Wait) {
+		// The oldest slot in flight is the one after the head
+		for(std::size_t Step = 0; Step < Slots.size(); Step++) {
+			Slot& Current = Slots[(Head + Step) % Slots.size()];
+			if(!Current.Fence) {
+				continue;
+
+			}
+
+			// Checking the fence, flushing so it actually gets to the GPU
+			GLenum Status = glClientWaitSync(Current.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, Wait ? GL_TIMEOUT_IGNORED : 0);
+			if(Status == GL_TIMEOUT_EXPIRED) {
+				// Later slots were read after this one, so they wont be done either
+				break;
+
+			}
+
+			// Leaving it in the ring while the worker is behind, so the queue doesnt grow without end
+			if(HasWorker && !WaitForQueueSpace(Wait)) {
+				break;
+
+			}
+
+			glDeleteSync(Current.Fence);
+			Current.Fence = nullptr;
+
+			// Mapping it, this doesnt stall since the copy is done
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, Current.Buffer);
+			const unsigned char* Pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (std::size_t)Current.Width * Current.Height * 4, GL_MAP_READ_BIT);
+			if(!Pixels) {
+				SR_LOG_ERROR("ReadbackInstance: Poll(): Could not map the pixel buffer.");
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+				continue;
+
+			}
+
+			if(HasWorker) {
+				// Copying it out for the worker
+				ReadbackJob Job;
+				Job.Pixels.assign(Pixels, Pixels + (std::size_t)Current.Width * Current.Height * 4);
+				Job.Width = Current.Width;
+				Job.Height = Current.Height;
+				Job.Frame = Current.Frame;
+				{
+					std::lock_guard<std::mutex> Lock(Mutex);
+					Jobs.push_back(std::move(Job));
+				}
+				Condition.notify_one();
+
+			} else {
+				// Calling it right here
+				ReadbackFrame Frame;
+				Frame.Pixels = Pixels;
+				Frame.Width = Current.Width;
+				Frame.Height = Current.Height;
+				Frame.Frame = Current.Frame;
+				Callback(Frame);
+
+			}
+
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			Delivered++;
+
+		}
+
+	}
+
+	/**
+	 * @brief Checks if the worker queue has space for another frame.
+	 * @param Wait Whether to wait for the worker to make space.
+	 * @return Returns a bool of whether a frame can be queued.
+	 */
+	bool WaitForQueueSpace(bool Wait) {
+		std::unique_lock<std::mutex> Lock(Mutex);
+		if(Wait) {
+			Idle.wait(Lock, [this]() { return Jobs.size() < Slots.size(); });
+
+		}
+
+		return Jobs.size() < Slots.size();
+
+	}
+
+	/**
+	 * @brief The worker thread.
+	 */
+	void Run() {
+		while(true) {
+			ReadbackJob Job;
+
+			// Waiting for a frame
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Condition.wait(Lock, [this]() { return Stopping || !Jobs.empty(); });
+
+				if(Jobs.empty()) {
+					break;
+
+				}
+
+				Job = std::move(Jobs.front());
+				Jobs.pop_front();
+				Busy = true;
+			}
+
+			// Handing it over
+			ReadbackFrame Frame;
+			Frame.Pixels = Job.Pixels.data();
+			Frame.Width = Job.Width;
+			Frame.Height = Job.Height;
+			Frame.Frame = Job.Frame;
+			Callback(Frame);
+
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Busy = false;
+			}
+			Idle.notify_all();
+
+		}
+
+	}
+
+	std::function<void(const ReadbackFrame&)> Callback;	// Called with every frame
+	std::vector<Slot> Slots;			// The ring
+	std::size_t Head = 0;				// Next slot to read into
+	std::uint64_t FrameCount = 0;		// Number of ReadFrame calls
+	std::uint64_t Skipped = 0;			// Frames skipped because the ring was full
+	std::uint64_t Delivered = 0;		// Frames handed over
+	bool HasBuffers = false;			// Bool guard determining whether the ring was made
+
+	bool HasWorker = false;				// Bool guard determining whether the worker is running
+	std::thread Thread;					// The worker
+	std::deque<ReadbackJob> Jobs;		// Frames waiting for the worker
+	std::mutex Mutex;					// Guards Jobs, Busy and Stopping
+	std::condition_variable Condition;	// Wakes the worker
+	std::condition_variable Idle;		// Wakes Flush when the worker finishes a frame
+	bool Busy = false;					// Whether the worker is in the callback
+	bool Stopping = false;				// Whether the worker should stop once the queue is empty
+
+};
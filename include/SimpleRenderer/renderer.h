@@ -11,9 +11,17 @@
  
 #pragma once
 
+#include <SimpleRenderer/bake.h>
 #include <SimpleRenderer/camera.h>
+#include <SimpleRenderer/capture.h>
+#include <SimpleRenderer/gpuculling.h>
+#include <SimpleRenderer/lighting.h>
+#include <SimpleRenderer/material.h>
 #include <SimpleRenderer/object.h>
+#include <SimpleRenderer/readback.h>
+#include <SimpleRenderer/resolution.h>
 #include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/sprite.h>
 #include <SimpleRenderer/window.h>
 
 #include <GL/glew.h>
@@ -43,7 +51,6 @@ public:
 		RenderRangeMax(_RenderRangeMax) 
 	{
 		// Doing starting functions
-		glViewport(0, 0, Window->GetWindowWidth(), Window->GetWindowHeight());
 		glEnable(GL_DEPTH_TEST);
 		
 		// Setting the window pointer
@@ -52,8 +59,83 @@ public:
 		// Setting cursor pos callback
 		Window->SetCursorPositionCallback(MouseCallback);
 		
+		// Setting the viewport and perspective matrix
+		UpdateViewport();
+		
+	}
+	
+	/**
+	 * @brief Sets the viewport and perspective matrix from the window size.
+	 * @note Called automatically when the window is resized.
+	 */
+	void UpdateViewport() {
+		int Width = Window->GetWindowWidth();
+		int Height = Window->GetWindowHeight();
+		
+		// Guard checking, aspect ratio would be garbage
+		if(Width <= 0 || Height <= 0) {
+			return;
+			
+		}
+		
+		// Setting the viewport
+		glViewport(0, 0, Width, Height);
+		
+		// Resizing the dynamic resolution target to match
+		if(DynamicResolution) {
+			DynamicResolution->Resize(Width, Height);
+			
+		}
+		
 		// Setting the perspective matrix
-		Perspective = glm::perspective(glm::radians(Camera->GetFOV()), (float)Window->GetWindowWidth() / (float)Window->GetWindowHeight(), RenderRangeMin, RenderRangeMax);
+		Aspect = (float)Width / (float)Height;
+		Perspective = glm::perspective(glm::radians(Camera->GetFOV()), Aspect, RenderRangeMin, RenderRangeMax);
+		
+	}
+	
+	/**
+	 * @brief Renders into a dynamic resolution target instead of straight to the window.
+	 * @param _DynamicResolution Pointer to the target, or nullptr to render straight to the window again.
+	 * @note The target is resized along with the window.
+	 */
+	void SetDynamicResolution(DynamicResolutionInstance* _DynamicResolution) {
+		DynamicResolution = _DynamicResolution;
+		
+		// Putting the full viewport back when going back to the window
+		if(!DynamicResolution) {
+			glViewport(0, 0, Window->GetWindowWidth(), Window->GetWindowHeight());
+			
+		}
+		
+	}
+	
+	/**
+	 * @brief Uses clustered lighting for every object rendered.
+	 * @param _Lighting Pointer to the lighting, or nullptr to turn it off.
+	 * @note The lights are binned at the start of every frame, and the lighting uniforms are set on every object's shader.
+	 */
+	void SetLighting(ClusteredLightingInstance* _Lighting) {
+		Lighting = _Lighting;
+		
+	}
+	
+	/**
+	 * @brief Records the next frames into a capture.
+	 * @param _Capture Pointer to the capture, or nullptr to stop giving it frames.
+	 * @see See CaptureInstance and ReplayInstance for what is recorded and how to play it back.
+	 */
+	void SetCapture(CaptureInstance* _Capture) {
+		Capture = _Capture;
+		
+	}
+	
+	/**
+	 * @brief Reads every finished frame back to the CPU, e.g for screenshots or video.
+	 * @param _Readback Pointer to the readback, or nullptr to stop reading frames.
+	 * @note Frames are read from the window just before the swap, at window size.
+	 */
+	void SetReadback(ReadbackInstance* _Readback) {
+		Readback = _Readback;
 		
 	}
 	
@@ -61,6 +143,18 @@ public:
 	 * @brief Function which initializes the renderer to begin drawing the frame.
 	 */
 	void StartFrame() {
+		// Handling resizes from the last frame
+		if(Window->WasResized()) {
+			UpdateViewport();
+			
+		}
+		
+		// Redirecting to the scaled target
+		if(DynamicResolution) {
+			DynamicResolution->BeginFrame();
+			
+		}
+		
 		// Color stuffs
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -69,6 +163,19 @@ public:
 		View = Camera->GetViewMatrix();
 		Camera->ProcessKeyboardInput(Window->GetWindowPointer());
 		
+		// Binning the lights for this view
+		if(Lighting) {
+			Lighting->Update(glm::make_mat4(View), Camera->GetFOV(), Aspect, RenderRangeMin, RenderRangeMax);
+			Lighting->Bind();
+			
+		}
+		
+		// Recording the camera
+		if(Capture) {
+			Capture->BeginFrame(Window->GetWindowWidth(), Window->GetWindowHeight(), View, glm::value_ptr(Perspective));
+			
+		}
+		
 	}
 	/**
 	 * @brief Calls WindowInstance.FinishFrame().
@@ -76,16 +183,51 @@ public:
 	 * @todo Maybe find a better way to do this?
 	 */
 	void FinishFrame() {
+		// Upscaling the scaled target to the window
+		if(DynamicResolution) {
+			DynamicResolution->EndFrame();
+			
+		}
+		
+		// Ending the captured frame
+		if(Capture) {
+			Capture->EndFrame();
+			
+		}
+		
+		// Reading the finished frame back
+		if(Readback) {
+			Readback->ReadFrame(Window->GetWindowWidth(), Window->GetWindowHeight());
+			
+		}
+		
 		Window->FinishFrame();
 	}
 	
+	/**
+	 * @brief Calls WindowInstance.GetFrameTimeStats().
+	 * @return Returns a FrameTimeStats with times in milliseconds.
+	 */
+	FrameTimeStats GetFrameTimeStats() {
+		return Window->GetFrameTimeStats();
+	}
+	
 	/**
 	 * @brief Renders a single object from a pointer.
 	 * @param Object ObjectInstance pointer to be renderered.
 	 */
 	void RenderObject(ObjectInstance* Object) {
+		// Finishing an upload from the loader if it is done
+		Object->Poll();
+		
 		// Guard checking
 		if(Object->CanRender()) {
+			// Recording the draw
+			if(Capture) {
+				Capture->RecordDraw(Object);
+				
+			}
+			
 			// Using the VAO
 			Object->UseVAO();
 			
@@ -100,6 +242,16 @@ public:
 			Shader->UseViewMatrix        (View);
 			Shader->UsePerspectiveMatrix (glm::value_ptr(Perspective));
 			
+			if(Lighting) {
+				Lighting->UseUniforms(Shader);
+				
+				if(Capture) {
+					Capture->RecordUnsupported("clustered lights");
+					
+				}
+				
+			}
+			
 			
 			// Actually drawing
 			glDrawElements(GL_TRIANGLES, Object->GetIndicesCount(), GL_UNSIGNED_INT, 0);
@@ -108,12 +260,100 @@ public:
 	
 	}
 	
+	/**
+	 * @brief Draws everything queued in a material batch.
+	 * @param Batch MaterialBatchInstance pointer to be rendered.
+	 * @see See MaterialBatchInstance for the attributes and uniforms its shaders need.
+	 */
+	void RenderMaterialBatch(MaterialBatchInstance* Batch) {
+		if(Capture) {
+			Capture->RecordUnsupported("material batches");
+			
+		}
+		
+		Batch->Draw(View, glm::value_ptr(Perspective));
+		
+	}
+	
+	/**
+	 * @brief Draws the chunks of a baked static batch that are inside the view.
+	 * @param Batch StaticBatchInstance pointer to be rendered.
+	 * @note Each chunk goes through RenderObject(), so lighting and captures work the same as for regular objects.
+	 */
+	void RenderStaticBatch(StaticBatchInstance* Batch) {
+		glm::mat4 ViewProjection = Perspective * glm::make_mat4(View);
+		for(ObjectInstance* Chunk : Batch->Cull(ViewProjection)) {
+			RenderObject(Chunk);
+			
+		}
+		
+	}
+	
+	/**
+	 * @brief Culls and draws GPU culled instances, with no CPU round trip.
+	 * @param Culling GPUCullingInstance pointer to be rendered.
+	 * @param Shader Shader to draw with, which reads the model matrix from the culling's transform buffer instead of uModel.
+	 * @note Nothing is culled or drawn until the shader is ready.
+	 * @note Draws are not recorded by captures, which get marked as incomplete.
+	 */
+	void RenderGPUCulled(GPUCullingInstance* Culling, ShaderInstance* Shader) {
+		// Waiting on the shader isnt an error, just not ready yet
+		if(!Shader->IsReady()) {
+			return;
+			
+		}
+		
+		if(Capture) {
+			Capture->RecordUnsupported("GPU culled draws");
+			
+		}
+		
+		// Culling on the GPU
+		glm::mat4 ViewProjection = Perspective * glm::make_mat4(View);
+		Culling->Cull(ViewProjection);
+		
+		// Using Shader
+		Shader->UseProgram();
+		Shader->UseViewMatrix        (View);
+		Shader->UsePerspectiveMatrix (glm::value_ptr(Perspective));
+		
+		if(Lighting) {
+			Lighting->UseUniforms(Shader);
+			
+		}
+		
+		// Drawing whatever survived
+		Culling->Draw();
+		
+	}
+	
+	/**
+	 * @brief Draws everything queued in a sprite batch, in pixel coordinates.
+	 * @param Batch SpriteBatchInstance pointer to be rendered.
+	 * @note (0, 0) is the top left of the window and y goes down.
+	 */
+	void RenderSpriteBatch(SpriteBatchInstance* Batch) {
+		if(Capture) {
+			Capture->RecordUnsupported("sprite batches");
+			
+		}
+		
+		glm::mat4 Projection = glm::ortho(0.0f, (float)Window->GetWindowWidth(), (float)Window->GetWindowHeight(), 0.0f, -1.0f, 1.0f);
+		Batch->Flush(glm::value_ptr(Projection));
+		
+	}
+	
 	
 private:
 	WindowInstance* Window;		// Window
 	CameraInstance* Camera;		// Camera 
+	DynamicResolutionInstance* DynamicResolution = nullptr;	// Optional scaled render target
+	ClusteredLightingInstance* Lighting = nullptr;			// Optional clustered lighting
+	CaptureInstance* Capture = nullptr;						// Optional frame capture
+	ReadbackInstance* Readback = nullptr;					// Optional frame readback
 	
 	glm::mat4 Perspective;		// The perspective matrix
+	float Aspect = 1.0f;		// Aspect ratio of the viewport
 	const float* View;			// The view matrix value pointer
 	
 	float FOV;					// The FOV of the camera.
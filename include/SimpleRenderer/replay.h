@@ -0,0 +1,526 @@
+/**
+ * @file replay.h
+ * @brief Contains the replayer, which draws the frames of a capture made with CaptureInstance.
+ * @note The whole capture is loaded and uploaded up front, so replaying a frame only does the same OpenGL calls the renderer did.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/capture.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+#include <SimpleRenderer/object.h>
+#include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/timing.h>
+#include <SimpleRenderer/vertex.h>
+
+/**
+ * @class ReplayInstance
+ * @brief Loads a capture file and draws its frames as fast as possible, timing each one.
+ * @note Frames are drawn into an offscreen framebuffer the size of the capture, so the window can be hidden and any size.
+ * @note Each frame ends with a glFinish, so the frame times include the GPU.
+ * @warning A context must be current when this is made, e.g from a hidden WindowInstance.
+ */
+class ReplayInstance {
+public:
+	ReplayInstance() {}			// Default constructor
+
+	/**
+	 * @brief Constructor which loads the capture and makes its shaders and objects.
+	 * @param Path Path of the capture file.
+	 */
+	ReplayInstance(const std::string& Path) {
+		// Reading the whole file
+		std::ifstream File(Path, std::ios::binary);
+		if(!File.is_open()) {
+			SR_LOG_ERROR("ReplayInstance: Constructor: %s file does not exist.", Path.c_str());
+			return;
+
+		}
+		Data.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+
+		// Checking the header
+		if(!Read(&Header, sizeof(Header)) || std::memcmp(Header.Magic, "SRCP", 4) != 0 || Header.Version != CaptureHeader().Version) {
+			SR_LOG_ERROR("ReplayInstance: Constructor: %s is not a capture file.", Path.c_str());
+			return;
+
+		}
+		if(Header.ByteOrder != CaptureHeader().ByteOrder) {
+			SR_LOG_ERROR("ReplayInstance: Constructor: %s was captured on a machine with a different byte order.", Path.c_str());
+			return;
+
+		}
+
+		// Going through the records
+		bool Ended = false;
+		while(!Ended) {
+			std::uint8_t Type;
+			if(!Read(&Type, 1) || !ParseRecord((CaptureRecord)Type, Ended)) {
+				SR_LOG_ERROR("ReplayInstance: Constructor: %s is truncated or corrupt.", Path.c_str());
+				return;
+
+			}
+
+		}
+
+		// Saying what the replay is missing
+		for(const std::string& What : Unsupported) {
+			SR_LOG_WARNING("ReplayInstance: Constructor: %s used %s, which are not in the capture. Replayed frames are missing that work.", Path.c_str(), What.c_str());
+
+		}
+
+		// Freeing the file, everything is on the GPU or in Commands now
+		Data = std::vector<char>();
+
+		// Making the framebuffer the frames are drawn into
+		glGenRenderbuffers(1, &ColorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, ColorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, Header.Width, Header.Height);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Renderbuffer, ColorBuffer, (std::size_t)Header.Width * Header.Height * 4, "ReplayInstance color");
+
+		glGenRenderbuffers(1, &DepthBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, DepthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Header.Width, Header.Height);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Renderbuffer, DepthBuffer, (std::size_t)Header.Width * Header.Height * 4, "ReplayInstance depth");
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &Framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ColorBuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, DepthBuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		HasFramebuffer = true;
+
+		// Setting the guard
+		Loaded = true;
+
+	}
+
+	/**
+	 * @brief Function to check if the capture loaded.
+	 * @return Returns a bool of whether the capture can be replayed.
+	 */
+	bool IsLoaded() {
+		return Loaded;
+
+	}
+
+	/**
+	 * @brief Function to check if the capture has everything the application drew.
+	 * @return Returns false if the application used renderer features the capture does not record, so the replay is a different workload.
+	 */
+	bool IsComplete() {
+		return Unsupported.empty();
+
+	}
+
+	/**
+	 * @brief Function to get the names of the features the capture did not record.
+	 * @return Returns the names, empty if the capture is complete.
+	 */
+	const std::vector<std::string>& GetUnsupported() {
+		return Unsupported;
+
+	}
+
+	/**
+	 * @brief Function to get the number of frames in the capture.
+	 * @return Returns the frame count.
+	 */
+	int GetFrameCount() {
+		return (int)FrameStarts.size();
+
+	}
+
+	/**
+	 * @brief Function to get the framebuffer width the capture was made at.
+	 * @return Returns the width in pixels.
+	 */
+	int GetWidth() {
+		return Header.Width;
+
+	}
+
+	/**
+	 * @brief Function to get the framebuffer height the capture was made at.
+	 * @return Returns the height in pixels.
+	 */
+	int GetHeight() {
+		return Header.Height;
+
+	}
+
+	/**
+	 * @brief Draws a single frame of the capture and waits for it to finish.
+	 * @param Frame Index of the frame.
+	 * @return Returns the time the frame took in milliseconds, including the GPU.
+	 * @note Model matrices carry over from earlier frames, so frames should be replayed in order.
+	 */
+	double ReplayFrame(int Frame) {
+		if(!Loaded || Frame < 0 || Frame >= GetFrameCount()) {
+			return 0.0;
+
+		}
+
+		// Starting the clock for this frame
+		Timer.ResetHistory();
+
+		// Same state the renderer starts a frame with
+		glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+		glEnable(GL_DEPTH_TEST);
+		glViewport(0, 0, Header.Width, Header.Height);
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Going through the frame's commands
+		const float* View = nullptr;
+		const float* Perspective = nullptr;
+		for(std::size_t Index = FrameStarts[Frame]; Index < Commands.size(); Index++) {
+			const Command& Current = Commands[Index];
+			if(Current.Type == CaptureRecord::FrameEnd) {
+				break;
+
+			}
+
+			switch(Current.Type) {
+				case CaptureRecord::Frame:
+					View = glm::value_ptr(Matrices[Current.Matrix]);
+					Perspective = glm::value_ptr(Matrices[Current.Matrix + 1]);
+					break;
+
+				case CaptureRecord::Transform:
+					Objects[Current.ID]->SetModelMatrix(glm::value_ptr(Matrices[Current.Matrix]));
+					break;
+
+				case CaptureRecord::Draw: {
+					// Same as RendererInstance.RenderObject()
+					ObjectInstance* Object = Objects[Current.ID].get();
+					if(Object->CanRender()) {
+						Object->UseVAO();
+						ShaderInstance* Shader = Object->GetShader();
+						Shader->UseProgram();
+						Shader->UseModelMatrix(Object->GetModelMatrix());
+						Shader->UseViewMatrix(View);
+						Shader->UsePerspectiveMatrix(Perspective);
+						glDrawElements(GL_TRIANGLES, Object->GetIndicesCount(), GL_UNSIGNED_INT, 0);
+
+					}
+					break;
+
+				}
+
+				default:
+					break;
+
+			}
+
+		}
+
+		// Waiting for the GPU so the time is the whole frame
+		glFinish();
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		Timer.MarkFrame();
+		return Timer.GetLastFrameTime();
+
+	}
+
+	/**
+	 * @brief Replays every frame in order.
+	 * @param Loops Number of times to go through the capture.
+	 * @return Returns the time of every frame in milliseconds, in the order they were drawn.
+	 */
+	std::vector<double> Run(int Loops = 1) {
+		std::vector<double> Times;
+		Times.reserve(GetFrameCount() * std::max(Loops, 0));
+
+		for(int Loop = 0; Loop < Loops; Loop++) {
+			for(int Frame = 0; Frame < GetFrameCount(); Frame++) {
+				Times.push_back(ReplayFrame(Frame));
+
+			}
+
+		}
+
+		return Times;
+
+	}
+
+	/**
+	 * @brief Deletes the framebuffer. The shaders and objects delete themselves.
+	 */
+	~ReplayInstance() {
+		if(!HasFramebuffer) {
+			return;
+
+		}
+
+		glDeleteFramebuffers(1, &Framebuffer);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Renderbuffer, ColorBuffer);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Renderbuffer, DepthBuffer);
+		glDeleteRenderbuffers(1, &ColorBuffer);
+		glDeleteRenderbuffers(1, &DepthBuffer);
+
+	}
+
+private:
+	/**
+	 * @struct Command
+	 * @brief A single per frame record, parsed ahead of time.
+	 */
+	struct Command {
+		CaptureRecord Type;
+		std::uint32_t ID = 0;			// Mesh ID, for transforms and draws
+		std::uint32_t Matrix = 0;		// Index into Matrices, for frames and transforms
+
+	};
+
+	/**
+	 * @brief Copies bytes out of the file data.
+	 * @return Returns false if the file ends first.
+	 */
+	bool Read(void* Destination, std::size_t Size) {
+		if(Size > Data.size() - Offset) {
+			return false;
+
+		}
+
+		std::memcpy(Destination, Data.data() + Offset, Size);
+		Offset += Size;
+		return true;
+
+	}
+
+	/**
+	 * @brief Checks the file has enough data left for an array, before anything is sized from a count in the file.
+	 * @param Count Number of elements.
+	 * @param ElementSize Size of each element in the file.
+	 * @return Returns false if the file ends first.
+	 */
+	bool HasData(std::size_t Count, std::size_t ElementSize) {
+		return Count <= (Data.size() - Offset) / ElementSize;
+
+	}
+
+	/**
+	 * @brief Reads a length prefixed string.
+	 * @return Returns false if the file ends first.
+	 */
+	bool ReadString(std::string& String) {
+		std::uint32_t Length;
+		if(!Read(&Length, sizeof(Length)) || Length > Data.size() - Offset) {
+			return false;
+
+		}
+
+		String.assign(Data.data() + Offset, Length);
+		Offset += Length;
+		return true;
+
+	}
+
+	/**
+	 * @brief Reads a matrix into Matrices.
+	 * @return Returns false if the file ends first.
+	 */
+	bool ReadMatrix() {
+		Matrices.push_back(glm::mat4(1.0f));
+		return Read(glm::value_ptr(Matrices.back()), sizeof(float) * 16);
+
+	}
+
+	/**
+	 * @brief Reads the body of a record, making shaders and objects or adding a command.
+	 * @param Type The type byte of the record.
+	 * @param Ended Set to true when the end record is reached.
+	 * @return Returns false if the record is truncated or refers to something that does not exist.
+	 */
+	bool ParseRecord(CaptureRecord Type, bool& Ended) {
+		Command Current;
+		Current.Type = Type;
+
+		switch(Type) {
+			case CaptureRecord::End:
+				Ended = true;
+				return true;
+
+			case CaptureRecord::Shader: {
+				std::uint32_t ID;
+				std::string VSrc, FSrc;
+				if(!Read(&ID, sizeof(ID)) || ID != Shaders.size() || !ReadString(VSrc) || !ReadString(FSrc)) {
+					return false;
+
+				}
+
+				Shaders.push_back(std::make_unique<ShaderInstance>());
+				Shaders.back()->CreateFromSource(VSrc, FSrc);
+				return true;
+
+			}
+
+			case CaptureRecord::Mesh: {
+				std::uint32_t ID, ShaderID, IndicesCount, VertexBytes;
+				if(!Read(&ID, sizeof(ID)) || ID != Objects.size() || !Read(&ShaderID, sizeof(ShaderID)) || ShaderID >= Shaders.size()) {
+					return false;
+
+				}
+				if(!Read(&IndicesCount, sizeof(IndicesCount))) {
+					return false;
+
+				}
+
+				// Reading the vertex layout, each attribute is 18 bytes in the file
+				std::uint32_t Stride, AttributeCount;
+				if(!Read(&Stride, sizeof(Stride)) || Stride == 0 || !Read(&AttributeCount, sizeof(AttributeCount)) || !HasData(AttributeCount, 18)) {
+					return false;
+
+				}
+				Layouts.emplace_back(AttributeCount);
+				for(VertexAttributeLayout& Attribute : Layouts.back()) {
+					std::uint32_t Fields[3];
+					std::uint8_t Flags[2];
+					std::uint32_t Offset;
+					if(!Read(Fields, sizeof(Fields)) || !Read(Flags, sizeof(Flags)) || !Read(&Offset, sizeof(Offset))) {
+						return false;
+
+					}
+					Attribute.Location = Fields[0];
+					Attribute.Components = (int)Fields[1];
+					Attribute.Type = (GLenum)Fields[2];
+					Attribute.Normalized = Flags[0] != 0;
+					Attribute.Integer = Flags[1] != 0;
+					Attribute.Offset = Offset;
+
+					// The attribute has to be inside the vertex
+					std::size_t TypeSize = GetVertexTypeSize(Attribute.Type);
+					if(Fields[1] < 1 || Fields[1] > 4 || TypeSize == 0 || (std::size_t)Offset + Fields[1] * TypeSize > Stride) {
+						return false;
+
+					}
+
+				}
+
+				// There has to be at least one whole vertex and both arrays have to be in the file
+				if(!Read(&VertexBytes, sizeof(VertexBytes)) || VertexBytes < Stride || VertexBytes % Stride != 0 || !HasData(VertexBytes, 1)) {
+					return false;
+
+				}
+
+				std::vector<char> Vertices(VertexBytes);
+				if(!Read(Vertices.data(), VertexBytes) || !HasData(IndicesCount, sizeof(unsigned int))) {
+					return false;
+
+				}
+
+				// Copying the data out, the file data may not be aligned
+				std::vector<unsigned int> Indices(IndicesCount);
+				if(!Read(Indices.data(), Indices.size() * sizeof(unsigned int))) {
+					return false;
+
+				}
+
+				// Every index has to point at a vertex
+				std::uint32_t VertexCount = VertexBytes / Stride;
+				for(unsigned int Index : Indices) {
+					if(Index >= VertexCount) {
+						return false;
+
+					}
+
+				}
+
+				// Making the object, the model matrix comes from a transform record
+				Objects.push_back(std::make_unique<ObjectInstance>(Shaders[ShaderID].get(), glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(0.0f)));
+				Objects.back()->CreateVAO(Vertices.data(), (int)(VertexBytes / Stride), (int)Stride, Layouts.back().data(), (int)AttributeCount, Indices.data(), (int)Indices.size());
+				return true;
+
+			}
+
+			case CaptureRecord::Transform:
+				if(!Read(&Current.ID, sizeof(Current.ID)) || Current.ID >= Objects.size()) {
+					return false;
+
+				}
+				Current.Matrix = (std::uint32_t)Matrices.size();
+				if(!ReadMatrix()) {
+					return false;
+
+				}
+				break;
+
+			case CaptureRecord::Frame:
+				FrameStarts.push_back(Commands.size());
+				Current.Matrix = (std::uint32_t)Matrices.size();
+				if(!ReadMatrix() || !ReadMatrix()) {
+					return false;
+
+				}
+				break;
+
+			case CaptureRecord::Draw:
+				if(!Read(&Current.ID, sizeof(Current.ID)) || Current.ID >= Objects.size()) {
+					return false;
+
+				}
+				break;
+
+			case CaptureRecord::FrameEnd:
+				break;
+
+			case CaptureRecord::Unsupported: {
+				std::string What;
+				if(!ReadString(What)) {
+					return false;
+
+				}
+
+				Unsupported.push_back(What);
+				return true;
+
+			}
+
+			default:
+				return false;
+
+		}
+
+		Commands.push_back(Current);
+		return true;
+
+	}
+
+	CaptureHeader Header;				// Header of the capture
+	std::vector<char> Data;				// The file, only kept while loading
+	std::size_t Offset = 0;				// Read position in Data
+	bool Loaded = false;				// Bool guard determining whether the capture loaded
+
+	std::vector<std::unique_ptr<ShaderInstance>> Shaders;	// Shaders, indexed by capture ID
+	std::vector<std::unique_ptr<ObjectInstance>> Objects;	// Objects, indexed by capture ID
+	std::vector<Command> Commands;		// Every per frame record in order
+	std::vector<std::size_t> FrameStarts;	// Index of each frame's first command
+	std::vector<glm::mat4> Matrices;	// Matrices the commands point into
+	std::vector<std::vector<VertexAttributeLayout>> Layouts;	// Vertex layouts of the objects, which point into these
+	std::vector<std::string> Unsupported;	// Features the application used that the capture does not record
+
+	FrameTimerInstance Timer;			// Times each frame
+
+	unsigned int Framebuffer = 0;		// Offscreen target the size of the capture
+	unsigned int ColorBuffer = 0;		// Color attachment of the framebuffer
+	unsigned int DepthBuffer = 0;		// Depth and stencil attachment of the framebuffer
+	bool HasFramebuffer = false;		// Bool guard determining whether the framebuffer was made
+
+};
@@ -0,0 +1,298 @@
+/**
+ * @file resolution.h
+ * @brief Contains the dynamic resolution render target.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <GL/glew.h>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+
+/**
+ * @class DynamicResolutionInstance
+ * @brief An offscreen render target whose resolution scale is adjusted every frame to keep GPU time under a budget.
+ * @note The buffers are allocated at full size and the scaled image is drawn into the corner of them, so changing the scale never reallocates.
+ * @note The scaled image is upscaled to the default framebuffer with a linear blit.
+ * @note GPU time is measured with GL_TIME_ELAPSED queries which are read back a few frames late so the CPU never waits on the GPU.
+ */
+class DynamicResolutionInstance {
+public:
+	DynamicResolutionInstance() {}		// Default constructor
+
+	/**
+	 * @brief Constructor which creates the render target.
+	 * @param _Width Full width in pixels, normally the framebuffer width of the window.
+	 * @param _Height Full height in pixels, normally the framebuffer height of the window.
+	 * @param _TargetGPUTime The GPU time budget per frame in milliseconds.
+	 * @param _MinScale The lowest the resolution scale can go, per axis. Clamped to 0.1 to 1.
+	 * @param _MaxScale The highest the resolution scale can go, per axis. Clamped to the min scale to 1, since the buffers are full size.
+	 * @warning The renderer must be initialized before creating this.
+	 */
+	DynamicResolutionInstance(int _Width, int _Height, float _TargetGPUTime, float _MinScale = 0.5f, float _MaxScale = 1.0f) :
+		TargetGPUTime(_TargetGPUTime),
+		MinScale(std::clamp(_MinScale, 0.1f, 1.0f)),
+		MaxScale(std::clamp(_MaxScale, MinScale, 1.0f))
+	{
+		// Starting at full scale
+		Scale = MaxScale;
+
+		// Creating the timer queries
+		glGenQueries(QueryCount, Queries);
+		HasQueries = true;
+
+		// Creating the buffers
+		Resize(_Width, _Height);
+
+	}
+
+	/**
+	 * @brief Recreates the buffers for a new full size.
+	 * @param _Width New full width in pixels.
+	 * @param _Height New full height in pixels.
+	 */
+	void Resize(int _Width, int _Height) {
+		// Guard checking, a minimized window has zero size
+		if(_Width <= 0 || _Height <= 0) {
+			return;
+
+		}
+
+		// Deleting the old buffers
+		DeleteBuffers();
+
+		Width = _Width;
+		Height = _Height;
+
+		// Creating the color buffer
+		glGenRenderbuffers(1, &ColorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, ColorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, Width, Height);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Renderbuffer, ColorBuffer, (std::size_t)Width * Height * 4, "DynamicResolutionInstance color");
+
+		// Creating the depth buffer
+		glGenRenderbuffers(1, &DepthBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, DepthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Width, Height);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Renderbuffer, DepthBuffer, (std::size_t)Width * Height * 4, "DynamicResolutionInstance depth");
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		// Creating the framebuffer
+		glGenFramebuffers(1, &FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, ColorBuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, DepthBuffer);
+
+		// Checking it worked
+		if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			SR_LOG_ERROR("DynamicResolutionInstance: Resize(): Framebuffer is not complete.");
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			DeleteBuffers();
+			return;
+
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Setting the guard
+		HasBuffers = true;
+
+	}
+
+	/**
+	 * @brief Binds the render target, sets the scaled viewport and starts timing the frame.
+	 * @note Called by RendererInstance.StartFrame() before clearing.
+	 */
+	void BeginFrame() {
+		// Guard checking
+		if(!HasBuffers) {
+			return;
+
+		}
+
+		// Working out the scaled size
+		ScaledWidth = std::max(1, (int)std::lround(Width * Scale));
+		ScaledHeight = std::max(1, (int)std::lround(Height * Scale));
+
+		// Binding and setting the viewport
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glViewport(0, 0, ScaledWidth, ScaledHeight);
+
+		// Starting the timer if there is a query that isnt still in flight
+		if(QueriesInFlight < QueryCount) {
+			glBeginQuery(GL_TIME_ELAPSED, Queries[QueryHead]);
+			Timing = true;
+
+		}
+
+	}
+
+	/**
+	 * @brief Stops timing, upscales the image to the default framebuffer and updates the scale.
+	 * @note Called by RendererInstance.FinishFrame() before swapping.
+	 */
+	void EndFrame() {
+		// Guard checking
+		if(!HasBuffers) {
+			return;
+
+		}
+
+		// Ending the timer
+		if(Timing) {
+			glEndQuery(GL_TIME_ELAPSED);
+			QueryHead = (QueryHead + 1) % QueryCount;
+			QueriesInFlight++;
+			Timing = false;
+
+		}
+
+		// Upscaling to the window
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(0, 0, ScaledWidth, ScaledHeight, 0, 0, Width, Height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		// Reading back any finished timers, oldest first
+		while(QueriesInFlight > 0) {
+			unsigned int Query = Queries[(QueryHead + QueryCount - QueriesInFlight) % QueryCount];
+
+			// Not waiting on the GPU
+			int Available = 0;
+			glGetQueryObjectiv(Query, GL_QUERY_RESULT_AVAILABLE, &Available);
+			if(!Available) {
+				break;
+
+			}
+
+			GLuint64 Nanoseconds = 0;
+			glGetQueryObjectui64v(Query, GL_QUERY_RESULT, &Nanoseconds);
+			QueriesInFlight--;
+
+			UpdateScale((float)(Nanoseconds / 1.0e6));
+
+		}
+
+	}
+
+	/**
+	 * @brief Sets the GPU time budget.
+	 * @param _TargetGPUTime The GPU time budget per frame in milliseconds.
+	 */
+	void SetTargetGPUTime(float _TargetGPUTime) {
+		TargetGPUTime = _TargetGPUTime;
+
+	}
+
+	/**
+	 * @brief Function to get the current resolution scale.
+	 * @return Returns the scale per axis, from MinScale to MaxScale.
+	 */
+	float GetScale() {
+		return Scale;
+
+	}
+
+	/**
+	 * @brief Function to get the last measured GPU time.
+	 * @return Returns the GPU time in milliseconds.
+	 */
+	float GetGPUTime() {
+		return GPUTime;
+
+	}
+
+	/**
+	 * @brief Deletes all OpenGL data associated with the render target.
+	 */
+	~DynamicResolutionInstance() {
+		// Guard checking, the default constructor creates nothing
+		if(!HasQueries) {
+			return;
+
+		}
+
+		DeleteBuffers();
+		glDeleteQueries(QueryCount, Queries);
+
+	}
+
+private:
+	/**
+	 * @brief Moves the scale towards the size that would fit the budget.
+	 * @param Milliseconds The measured GPU time of a frame.
+	 */
+	void UpdateScale(float Milliseconds) {
+		GPUTime = Milliseconds;
+
+		// Guard checking
+		if(Milliseconds <= 0.0f || TargetGPUTime <= 0.0f) {
+			return;
+
+		}
+
+		// Not touching anything if we are close enough, otherwise the scale wobbles every frame
+		float Ratio = TargetGPUTime / Milliseconds;
+		if(Ratio > 0.95f && Ratio < 1.05f) {
+			return;
+
+		}
+
+		// GPU time goes roughly with pixel count, which is scale squared
+		float Wanted = Scale * std::sqrt(Ratio);
+
+		// Dropping quickly when over budget, growing slowly when under
+		float Rate = Ratio < 1.0f ? 0.5f : 0.1f;
+		Scale = std::clamp(Scale + (Wanted - Scale) * Rate, MinScale, MaxScale);
+
+	}
+
+	/**
+	 * @brief Deletes the framebuffer and its attachments.
+	 */
+	void DeleteBuffers() {
+		if(FBO) {
+			glDeleteFramebuffers(1, &FBO);
+		}
+		if(ColorBuffer) {
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Renderbuffer, ColorBuffer);
+			glDeleteRenderbuffers(1, &ColorBuffer);
+		}
+		if(DepthBuffer) {
+			MemoryTrackerInstance::Get().Untrack(MemoryCategory::Renderbuffer, DepthBuffer);
+			glDeleteRenderbuffers(1, &DepthBuffer);
+		}
+
+		FBO = ColorBuffer = DepthBuffer = 0;
+		HasBuffers = false;
+
+	}
+
+	static const int QueryCount = 4;	// Number of timer queries, how many frames late the GPU time can be read
+
+	unsigned int FBO = 0;				// The framebuffer
+	unsigned int ColorBuffer = 0;		// Color attachment
+	unsigned int DepthBuffer = 0;		// Depth/stencil attachment
+	unsigned int Queries[QueryCount] = {};	// Timer queries
+	int QueryHead = 0;					// The next query to use
+	int QueriesInFlight = 0;			// Queries which have been ended but not read
+	bool Timing = false;				// Whether a query is running this frame
+	bool HasBuffers = false;			// Bool guard determining whether the framebuffer is usable
+	bool HasQueries = false;			// Bool guard determining whether the queries have been created
+
+	int Width = 0;						// Full width in pixels
+	int Height = 0;						// Full height in pixels
+	int ScaledWidth = 0;				// Width of the scaled image this frame
+	int ScaledHeight = 0;				// Height of the scaled image this frame
+
+	float TargetGPUTime = 0.0f;			// GPU time budget in milliseconds
+	float GPUTime = 0.0f;				// Last measured GPU time in milliseconds
+	float Scale = 1.0f;					// Current scale per axis
+	float MinScale = 0.5f;				// Lowest scale per axis
+	float MaxScale = 1.0f;				// Highest scale per axis
+
+};
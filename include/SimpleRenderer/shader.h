@@ -7,10 +7,15 @@
 
 #include <string>
 #include <fstream>
-#include <iostream>
+#include <memory>
+#include <unordered_map>
 
 #include <GL/glew.h>
 
+#include <SimpleRenderer/loader.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+
 #include <glm/gtc/type_ptr.hpp>
 
 /**
@@ -24,7 +29,7 @@ std::string GetContentFromFile(std::string Path) {
 	std::ifstream File(Path);
 	
 	if(!File.is_open()) {
-		std::cout << "Error: GetContentFromFile: " << Path << " file does not exist.\n";
+		SR_LOG_ERROR("GetContentFromFile: %s file does not exist.", Path.c_str());
 		return "";
 	}
 	
@@ -44,7 +49,7 @@ std::string GetContentFromFile(std::string Path) {
 /**
  * @brief A simple class which handles shader creation and use w/uniforms. 
  * @todo Add a method which allows for checking to make sure that the data is in the shader.
- * @todo Implement more uniforms besides just matrices
+ * @todo Implement more uniforms besides int, float and vec4
  * @todo Make sure to implement a static vs dynamic thing for uniforms
  * @todo Make the matrices apply to the uniforms system instead of their own thing
  * @todo Add guards checking for using matrices
@@ -61,13 +66,159 @@ public:
 	 * @todo Try to lessen memory footprint with strings.
 	 */
 	ShaderInstance(std::string VPath, std::string FPath) {
-		// Getting file contents
-		std::string VSrcStr = GetContentFromFile(VPath);
-		std::string FSrcStr = GetContentFromFile(FPath);
+		CreateProgram(VPath, FPath);
+		
+	}
+	
+	/**
+	 * @brief A constructor which reads and compiles the shader on a loader thread.
+	 * @param Loader Pointer to the loader which compiles the shader.
+	 * @param VPath Filepath of the vertex shader.
+	 * @param FPath Filepath of the fragment shader.
+	 * @note Objects using the shader do not render until IsReady() returns true.
+	 */
+	ShaderInstance(LoaderInstance* Loader, std::string VPath, std::string FPath) {
+		Upload = Loader->Submit([this, VPath, FPath]() {
+			CreateProgram(VPath, FPath);
+			
+		});
+		
+	}
+	
+	/**
+	 * @brief Function which checks whether the program can be used yet.
+	 * @return Returns a bool of whether the program has finished being made. Always true when not made on a loader.
+	 */
+	bool IsReady() {
+		// Nothing in flight
+		if(!Upload) {
+			return true;
+			
+		}
+		
+		// Dropping the fence once it has signalled
+		if(Upload->IsReady()) {
+			Upload.reset();
+			return true;
+			
+		}
 		
-		// Turning file contents into C string
-		const char* VSrc = VSrcStr.c_str();
-		const char* FSrc = FSrcStr.c_str();
+		return false;
+		
+	}
+	
+	/**
+	 * 
+	 */
+	void UseModelMatrix(const float* Matrix) {
+		glUniformMatrix4fv(Model, 1, GL_FALSE, Matrix);
+
+		
+	}
+	
+	/**
+	 * 
+	 */
+	void UseViewMatrix(const float* Matrix) {
+		 glUniformMatrix4fv(View, 1, GL_FALSE, Matrix);
+		 
+	}
+	 
+	/**
+	 * 
+	 */
+	void UsePerspectiveMatrix(const float* Matrix) {
+		glUniformMatrix4fv(Perspective, 1, GL_FALSE, Matrix);
+		
+	}
+	
+	/**
+	 * @brief Sets an int uniform, e.g a sampler's texture unit.
+	 * @param Name Name of the uniform.
+	 * @param Value The value to set.
+	 * @warning The program must be in use.
+	 */
+	void UseInt(const std::string& Name, int Value) {
+		glUniform1i(GetUniformLocation(Name), Value);
+		
+	}
+	
+	/**
+	 * @brief Sets a float uniform.
+	 * @param Name Name of the uniform.
+	 * @param Value The value to set.
+	 * @warning The program must be in use.
+	 */
+	void UseFloat(const std::string& Name, float Value) {
+		glUniform1f(GetUniformLocation(Name), Value);
+		
+	}
+	
+	/**
+	 * @brief Sets a vec4 uniform.
+	 * @param Name Name of the uniform.
+	 * @param Value The value to set.
+	 * @warning The program must be in use.
+	 */
+	void UseVec4(const std::string& Name, glm::vec4 Value) {
+		glUniform4f(GetUniformLocation(Name), Value.x, Value.y, Value.z, Value.w);
+		
+	}
+	
+	/**
+	 * @brief Gets the location of a uniform, only asking OpenGL the first time.
+	 * @param Name Name of the uniform.
+	 * @return Returns the location, or -1 if the uniform is not in the program.
+	 */
+	int GetUniformLocation(const std::string& Name) {
+		// Looking in the cache
+		auto Found = UniformLocations.find(Name);
+		if(Found != UniformLocations.end()) {
+			return Found->second;
+			
+		}
+		
+		// Asking OpenGL and remembering it
+		int Location = glGetUniformLocation(ID, Name.c_str());
+		UniformLocations[Name] = Location;
+		return Location;
+		
+	}
+	
+	/**
+	 * @brief Function to get the OpenGL ID of the program.
+	 * @return Returns the program ID.
+	 */
+	unsigned int GetID() {
+		return ID;
+		
+	}
+	
+	/**
+	 * @brief Function which uses the program stored in the class.
+	 */
+	void UseProgram() {
+		if(!ProgramCreated) {
+			SR_LOG_ERROR("ShaderInstance: UseProgram(): Program has not been created.");
+			return;
+		}
+		glUseProgram(ID);
+	}
+	
+	/**
+	 * @brief Compiles and links the program from source instead of files, and gets the uniform locations.
+	 * @param VSrcStr Source of the vertex shader.
+	 * @param FSrcStr Source of the fragment shader.
+	 * @note Meant for shaders made in code or loaded from somewhere else, like a capture. Use on a default constructed shader.
+	 */
+	void CreateFromSource(const std::string& VSrcStr, const std::string& FSrcStr) {
+		// Keeping the sources, so captures have exactly what was compiled
+		VertexSource = VSrcStr;
+		FragmentSource = FSrcStr;
+		
+		// Turning the sources into C strings
+		const char* VSrc = VertexSource.c_str();
+		const char* FSrc = FragmentSource.c_str();
 		
 		// Creating vertex shader
 		unsigned int VertexShader = glCreateShader(GL_VERTEX_SHADER);
@@ -80,7 +231,7 @@ public:
 		if(!Success) {
 			char InfoLog[512];
 			glGetShaderInfoLog(VertexShader, 512, NULL, InfoLog);
-			std::cout << "Error: ShaderInstance: ShaderInstance(): Vertex Shader compilation failed. Info Log: " << InfoLog << "\n";
+			SR_LOG_ERROR("ShaderInstance: ShaderInstance(): Vertex Shader compilation failed. Info Log: %s", InfoLog);
 		}
 		
 		// Creating fragment shader
@@ -93,7 +244,7 @@ public:
 		if(!Success) {
 			char InfoLog[512];
 			glGetShaderInfoLog(FragmentShader, 512, NULL, InfoLog);
-			std::cout << "Error: ShaderInstance: ShaderInstance(): Fragment Shader compilation failed. Info Log: " << InfoLog << "\n";
+			SR_LOG_ERROR("ShaderInstance: ShaderInstance(): Fragment Shader compilation failed. Info Log: %s", InfoLog);
 		}
 		
 		// Creating program
@@ -109,12 +260,13 @@ public:
 		if (!Success) {
 			char InfoLog[512];
 			glGetProgramInfoLog(ID, 512, NULL, InfoLog);
-			std::cout << "Error: ShaderInstance: Shader program linking failed. Info Log: " << InfoLog << "\n";
+			SR_LOG_ERROR("ShaderInstance: Shader program linking failed. Info Log: %s", InfoLog);
 		}
 		
 		// Deleting shader
 		glDeleteShader(VertexShader);
 		glDeleteShader(FragmentShader);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Program, ID, MemoryTrackerInstance::GetProgramSize(ID), "ShaderInstance");
 		
 		// Getting uniform locations
 		Model = glGetUniformLocation(ID, "uModel");
@@ -127,62 +279,92 @@ public:
 	}
 	
 	/**
-	 * 
+	 * @brief Function to get the path of the vertex shader.
+	 * @return Returns the path, empty if the shader was made from source.
 	 */
-	void UseModelMatrix(const float* Matrix) {
-		glUniformMatrix4fv(Model, 1, GL_FALSE, Matrix);
-
+	const std::string& GetVertexPath() {
+		return VertexPath;
 		
 	}
 	
 	/**
-	 * 
+	 * @brief Function to get the path of the fragment shader.
+	 * @return Returns the path, empty if the shader was made from source.
 	 */
-	void UseViewMatrix(const float* Matrix) {
-		 glUniformMatrix4fv(View, 1, GL_FALSE, Matrix);
-		 
+	const std::string& GetFragmentPath() {
+		return FragmentPath;
+		
 	}
-	 
+	
 	/**
-	 * 
+	 * @brief Function to get the source the vertex shader was compiled from.
+	 * @return Returns the source, empty if the program has not been created.
 	 */
-	void UsePerspectiveMatrix(const float* Matrix) {
-		glUniformMatrix4fv(Perspective, 1, GL_FALSE, Matrix);
+	const std::string& GetVertexSource() {
+		return VertexSource;
 		
 	}
 	
 	/**
-	 * @brief Function which uses the program stored in the class.
+	 * @brief Function to get the source the fragment shader was compiled from.
+	 * @return Returns the source, empty if the program has not been created.
 	 */
-	void UseProgram() {
-		if(!ProgramCreated) {
-			std::cout << "Error: ShaderInstance: UseProgram(): Program has not been created.\n";
-			return;
-		}
-		glUseProgram(ID);
+	const std::string& GetFragmentSource() {
+		return FragmentSource;
+		
 	}
 	
 	/** 
 	 * @brief Function which deletes the shader program.
 	 */
 	~ShaderInstance() {
+		// Waiting out a compile on the loader, it uses this
+		if(Upload) {
+			Upload->Wait();
+			
+		}
+		
 		// Guard checking
 		if(!ProgramCreated) {
-			std::cout << "Error: ShaderInstance: Deconstructor: Program has not been created.\n";
+			SR_LOG_ERROR("ShaderInstance: Deconstructor: Program has not been created.");
 			return;
 		}
 		
 		// Deleting program
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Program, ID);
 		glDeleteProgram(ID);
 		
 	}
 	
 private:
+	/**
+	 * @brief Reads, compiles and links the program, and gets the uniform locations.
+	 * @param VPath Filepath of the vertex shader.
+	 * @param FPath Filepath of the fragment shader.
+	 */
+	void CreateProgram(const std::string& VPath, const std::string& FPath) {
+		// Remembering where the sources came from
+		VertexPath = VPath;
+		FragmentPath = FPath;
+		
+		// Getting file contents and compiling them
+		CreateFromSource(GetContentFromFile(VPath), GetContentFromFile(FPath));
+		
+	}
+	
 	unsigned int ID;			// The OpenGL ID of the shader program.
 	bool ProgramCreated = false;// A bool representing whether or not the program has been created.
+	std::shared_ptr<UploadFence> Upload;	// Fence of the loader compile, null when not made on a loader
 	
 	int Model = -1;					// Location of model matrix uniform
 	int View = -1;					// Location of view matrix uniform
 	int Perspective = -1;			// Location of perspective matrix uniform
 	
+	std::unordered_map<std::string, int> UniformLocations;	// Cache of other uniform locations
+	
+	std::string VertexPath;		// Path of the vertex shader, empty if made from source
+	std::string FragmentPath;	// Path of the fragment shader, empty if made from source
+	std::string VertexSource;	// Source the vertex shader was compiled from
+	std::string FragmentSource;	// Source the fragment shader was compiled from
+	
 };
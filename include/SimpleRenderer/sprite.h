@@ -0,0 +1,364 @@
+/**
+ * @file sprite.h
+ * @brief Contains the sprite batch, which draws lots of 2D quads in very few draw calls.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+#include <SimpleRenderer/material.h>
+#include <SimpleRenderer/shader.h>
+
+/**
+ * @class SpriteBatchInstance
+ * @brief Collects quads and draws them from a streaming vertex buffer, one draw per texture array.
+ * @note Sprites are grouped by texture array, keeping submission order inside each group. Sprites in different layers of the same array share a draw.
+ * @note The shader gets these vertex attributes:
+ * - 0: vec2 position
+ * - 1: vec2 UV
+ * - 2: float layer
+ * - 3: vec4 color
+ * @note The projection goes into "uPerspective" and the texture array is bound to unit 0 for the "uSpriteTextures" sampler2DArray.
+ * @note Depth testing is turned off and alpha blending on while the batch draws, sprites are drawn in order.
+ * @warning The renderer must be initialized before creating a sprite batch.
+ */
+class SpriteBatchInstance {
+public:
+	SpriteBatchInstance() {}			// Default constructor
+
+	/**
+	 * @brief Constructor which makes the buffers.
+	 * @param _Shader The shader to draw the sprites with.
+	 * @param _Capacity Max sprites per draw call. More sprites than this just take more draws. Clamped to 1 - 16777216.
+	 */
+	SpriteBatchInstance(ShaderInstance* _Shader, int _Capacity = 65536) : Shader(_Shader), Capacity(std::clamp(_Capacity, 1, 1 << 24)) {
+		// Guard checking, a batch that holds nothing would never get through a flush
+		if(Capacity != _Capacity) {
+			SR_LOG_WARNING("SpriteBatchInstance: Constructor: Capacity of %d is out of range, using %d.", _Capacity, Capacity);
+
+		}
+
+		// Making the static index buffer, every quad is the same two triangles
+		std::vector<unsigned int> Indices(Capacity * 6);
+		for(int Quad = 0; Quad < Capacity; Quad++) {
+			unsigned int Base = Quad * 4;
+			Indices[Quad * 6 + 0] = Base + 0;
+			Indices[Quad * 6 + 1] = Base + 1;
+			Indices[Quad * 6 + 2] = Base + 2;
+			Indices[Quad * 6 + 3] = Base + 2;
+			Indices[Quad * 6 + 4] = Base + 3;
+			Indices[Quad * 6 + 5] = Base + 0;
+
+		}
+
+		// Creating vertex array object
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+
+		// Creating the streaming vertex buffer, storage is given on every flush
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, VBO, Capacity * 4 * sizeof(SpriteVertex), "SpriteBatchInstance vertices");
+
+		// Creating index buffer object
+		glGenBuffers(1, &IBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int), Indices.data(), GL_STATIC_DRAW);
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, IBO, Indices.size() * sizeof(unsigned int), "SpriteBatchInstance indices");
+
+		// Vertex attributes
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Position));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, UV));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Layer));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, Color));
+		glEnableVertexAttribArray(3);
+
+		glBindVertexArray(0);
+
+		// Setting the guard
+		BuffersCreated = true;
+
+	}
+
+	/**
+	 * @brief Queues a sprite.
+	 * @param Array The texture array to sample.
+	 * @param Layer The layer in the array.
+	 * @param Position Position of the center of the sprite.
+	 * @param Size Width and height of the sprite.
+	 * @param Rotation Rotation around the center, in degrees.
+	 * @param Color Color multiplied with the texture.
+	 * @param UVRect Offset (xy) and scale (zw) of the UVs, for atlases.
+	 */
+	void Draw(TextureArrayInstance* Array, int Layer, glm::vec2 Position, glm::vec2 Size, float Rotation = 0.0f, glm::vec4 Color = glm::vec4(1.0f), glm::vec4 UVRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)) {
+		// Finding the group for the array, there are only ever a few so a linear search is fine
+		SpriteGroup* Group = nullptr;
+		for(SpriteGroup& Existing : Groups) {
+			if(Existing.Array == Array) {
+				Group = &Existing;
+				break;
+
+			}
+
+		}
+
+		if(!Group) {
+			Groups.push_back({ Array, {} });
+			Group = &Groups.back();
+
+		}
+
+		// Packing the color
+		std::uint32_t PackedColor =
+			(std::uint32_t)(glm::clamp(Color.x, 0.0f, 1.0f) * 255.0f + 0.5f) |
+			((std::uint32_t)(glm::clamp(Color.y, 0.0f, 1.0f) * 255.0f + 0.5f) << 8) |
+			((std::uint32_t)(glm::clamp(Color.z, 0.0f, 1.0f) * 255.0f + 0.5f) << 16) |
+			((std::uint32_t)(glm::clamp(Color.w, 0.0f, 1.0f) * 255.0f + 0.5f) << 24);
+
+		Group->Sprites.push_back({ Position, Size, Rotation, (float)Layer, PackedColor, UVRect });
+		SpriteCount++;
+
+	}
+
+	/**
+	 * @brief Draws every queued sprite and clears the queue.
+	 * @param Projection The projection matrix value pointer.
+	 * @note Use RendererInstance.RenderSpriteBatch() instead for a pixel space projection.
+	 */
+	void Flush(const float* Projection) {
+		DrawCalls = 0;
+
+		// Guard checking
+		if(!BuffersCreated || !Shader) {
+			SR_LOG_ERROR("SpriteBatchInstance: Flush(): Buffers or shader have not been created.");
+			Clear();
+			return;
+
+		}
+
+		if(SpriteCount == 0 || !Shader->IsReady()) {
+			Clear();
+			return;
+
+		}
+
+		// 2D state
+		GLboolean DepthWasOn = glIsEnabled(GL_DEPTH_TEST);
+		GLboolean BlendWasOn = glIsEnabled(GL_BLEND);
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		// Program
+		Shader->UseProgram();
+		Shader->UsePerspectiveMatrix(Projection);
+		Shader->UseInt("uSpriteTextures", 0);
+
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+		// One group per texture array
+		for(SpriteGroup& Group : Groups) {
+			if(Group.Sprites.empty()) {
+				continue;
+
+			}
+
+			if(Group.Array) {
+				Group.Array->Bind(0);
+
+			}
+
+			// Splitting into chunks of the capacity
+			std::size_t First = 0;
+			while(First < Group.Sprites.size()) {
+				int Count = (int)std::min<std::size_t>(Capacity, Group.Sprites.size() - First);
+
+				// Orphaning the buffer so the GPU can keep reading the old one, then writing the quads straight into it
+				std::size_t Size = (std::size_t)Count * 4 * sizeof(SpriteVertex);
+				glBufferData(GL_ARRAY_BUFFER, Capacity * 4 * sizeof(SpriteVertex), NULL, GL_STREAM_DRAW);
+				SpriteVertex* Vertices = (SpriteVertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, Size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+				if(!Vertices) {
+					SR_LOG_ERROR("SpriteBatchInstance: Flush(): Could not map the vertex buffer.");
+					break;
+
+				}
+
+				for(int Index = 0; Index < Count; Index++) {
+					WriteQuad(Group.Sprites[First + Index], Vertices + Index * 4);
+
+				}
+
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+
+				// Drawing the chunk
+				glDrawElements(GL_TRIANGLES, Count * 6, GL_UNSIGNED_INT, 0);
+				DrawCalls++;
+
+				First += Count;
+
+			}
+
+		}
+
+		glBindVertexArray(0);
+
+		// Putting the state back
+		if(DepthWasOn) {
+			glEnable(GL_DEPTH_TEST);
+		}
+		if(!BlendWasOn) {
+			glDisable(GL_BLEND);
+		}
+
+		Clear();
+
+	}
+
+	/**
+	 * @brief Drops every queued sprite without drawing.
+	 * @note Keeps the group memory around so the next frame doesnt allocate.
+	 */
+	void Clear() {
+		for(SpriteGroup& Group : Groups) {
+			Group.Sprites.clear();
+
+		}
+
+		SpriteCount = 0;
+
+	}
+
+	/**
+	 * @brief Function to get the number of queued sprites.
+	 * @return Returns the number of sprites queued since the last Flush().
+	 */
+	int GetSpriteCount() {
+		return SpriteCount;
+
+	}
+
+	/**
+	 * @brief Function to get the number of draw calls the last Flush() made.
+	 * @return Returns the draw call count.
+	 */
+	int GetDrawCallCount() {
+		return DrawCalls;
+
+	}
+
+	/**
+	 * @brief Function which deletes all OpenGL data associated with the batch.
+	 */
+	~SpriteBatchInstance() {
+		// Guard checking
+		if(!BuffersCreated) {
+			return;
+
+		}
+
+		glDeleteVertexArrays(1, &VAO);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, VBO);
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, IBO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &IBO);
+
+	}
+
+private:
+	/**
+	 * @struct SpriteVertex
+	 * @brief A single vertex in the vertex buffer.
+	 */
+	struct SpriteVertex {
+		glm::vec2 Position;
+		glm::vec2 UV;
+		float Layer;
+		std::uint32_t Color;
+
+	};
+
+	/**
+	 * @struct Sprite
+	 * @brief A queued sprite.
+	 */
+	struct Sprite {
+		glm::vec2 Position;
+		glm::vec2 Size;
+		float Rotation;
+		float Layer;
+		std::uint32_t Color;
+		glm::vec4 UVRect;
+
+	};
+
+	/**
+	 * @struct SpriteGroup
+	 * @brief Queued sprites which use the same texture array.
+	 */
+	struct SpriteGroup {
+		TextureArrayInstance* Array;
+		std::vector<Sprite> Sprites;
+
+	};
+
+	/**
+	 * @brief Writes the four corners of a sprite.
+	 * @param Source The sprite.
+	 * @param Out Where to write the 4 vertices.
+	 */
+	static void WriteQuad(const Sprite& Source, SpriteVertex* Out) {
+		// Half extents along the rotated axes
+		glm::vec2 HalfSize = Source.Size * 0.5f;
+		glm::vec2 AxisX(HalfSize.x, 0.0f);
+		glm::vec2 AxisY(0.0f, HalfSize.y);
+
+		if(Source.Rotation != 0.0f) {
+			float Cos = std::cos(glm::radians(Source.Rotation));
+			float Sin = std::sin(glm::radians(Source.Rotation));
+			AxisX = glm::vec2(Cos * HalfSize.x, Sin * HalfSize.x);
+			AxisY = glm::vec2(-Sin * HalfSize.y, Cos * HalfSize.y);
+
+		}
+
+		// UV corners
+		float U0 = Source.UVRect.x;
+		float V0 = Source.UVRect.y;
+		float U1 = Source.UVRect.x + Source.UVRect.z;
+		float V1 = Source.UVRect.y + Source.UVRect.w;
+
+		Out[0] = { Source.Position - AxisX - AxisY, glm::vec2(U0, V0), Source.Layer, Source.Color };
+		Out[1] = { Source.Position + AxisX - AxisY, glm::vec2(U1, V0), Source.Layer, Source.Color };
+		Out[2] = { Source.Position + AxisX + AxisY, glm::vec2(U1, V1), Source.Layer, Source.Color };
+		Out[3] = { Source.Position - AxisX + AxisY, glm::vec2(U0, V1), Source.Layer, Source.Color };
+
+	}
+
+	ShaderInstance* Shader = nullptr;		// Shader the sprites are drawn with
+	unsigned int VAO = 0;					// The vertex array object
+	unsigned int VBO = 0;					// The streaming vertex buffer
+	unsigned int IBO = 0;					// The static index buffer
+	bool BuffersCreated = false;			// Bool guard determining whether the buffers have been created
+	int Capacity = 0;						// Max sprites per draw
+
+	std::vector<SpriteGroup> Groups;		// Queued sprites, one group per texture array
+	int SpriteCount = 0;					// Number of queued sprites
+	int DrawCalls = 0;						// Draw calls made by the last flush
+
+};
@@ -5,8 +5,23 @@
  
 #pragma once
  
+#include <SimpleRenderer/bake.h>
 #include <SimpleRenderer/camera.h>
+#include <SimpleRenderer/capture.h>
+#include <SimpleRenderer/gpuculling.h>
+#include <SimpleRenderer/lighting.h>
+#include <SimpleRenderer/loader.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/material.h>
+#include <SimpleRenderer/memory.h>
 #include <SimpleRenderer/object.h>
+#include <SimpleRenderer/readback.h>
 #include <SimpleRenderer/renderer.h>
+#include <SimpleRenderer/replay.h>
+#include <SimpleRenderer/resolution.h>
 #include <SimpleRenderer/shader.h>
+#include <SimpleRenderer/sprite.h>
+#include <SimpleRenderer/texture.h>
+#include <SimpleRenderer/timing.h>
+#include <SimpleRenderer/vertex.h>
 #include <SimpleRenderer/window.h>
@@ -0,0 +1,1111 @@
+/**
+ * @file texture.h
+ * @brief Contains texture loading, creation and streaming.
+ * @note Block compressed (BCn) data from DDS and KTX2 files is uploaded as is, it is never decompressed on the CPU.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include <SimpleRenderer/loader.h>
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/memory.h>
+
+/**
+ * @struct TextureFormat
+ * @brief Describes how texture data is laid out and which OpenGL format it uses.
+ * @note Uncompressed formats count as 1x1 blocks.
+ */
+struct TextureFormat {
+	unsigned int InternalFormat = 0;	// Sized OpenGL internal format, e.g GL_RGBA8 or GL_COMPRESSED_RGBA_BPTC_UNORM
+	unsigned int Format = 0;			// Pixel format for uncompressed uploads, e.g GL_RGBA
+	unsigned int Type = 0;				// Pixel type for uncompressed uploads, e.g GL_UNSIGNED_BYTE
+	int BlockSize = 1;					// Width and height of a block in pixels, 4 for BCn
+	int BytesPerBlock = 4;				// Size of a block in bytes
+	bool Compressed = false;			// Whether the format is block compressed
+
+	/**
+	 * @brief Gets the size of one mip level.
+	 * @param Width Width of the level in pixels.
+	 * @param Height Height of the level in pixels.
+	 * @return Returns the size of the level in bytes.
+	 */
+	std::size_t GetLevelSize(int Width, int Height) const {
+		std::size_t BlocksX = std::max(1, (Width + BlockSize - 1) / BlockSize);
+		std::size_t BlocksY = std::max(1, (Height + BlockSize - 1) / BlockSize);
+		return BlocksX * BlocksY * BytesPerBlock;
+
+	}
+
+	/**
+	 * @brief Makes an uncompressed format.
+	 */
+	static TextureFormat Uncompressed(unsigned int InternalFormat, unsigned int Format, unsigned int Type, int BytesPerPixel) {
+		TextureFormat Result;
+		Result.InternalFormat = InternalFormat;
+		Result.Format = Format;
+		Result.Type = Type;
+		Result.BytesPerBlock = BytesPerPixel;
+		return Result;
+
+	}
+
+	/**
+	 * @brief Makes a 4x4 block compressed format.
+	 */
+	static TextureFormat BlockCompressed(unsigned int InternalFormat, int BytesPerBlock) {
+		TextureFormat Result;
+		Result.InternalFormat = InternalFormat;
+		Result.BlockSize = 4;
+		Result.BytesPerBlock = BytesPerBlock;
+		Result.Compressed = true;
+		return Result;
+
+	}
+
+};
+
+/**
+ * @struct TextureLevel
+ * @brief Where one mip level is inside TextureData.Bytes.
+ */
+struct TextureLevel {
+	int Width = 0;				// Width of the level in pixels
+	int Height = 0;				// Height of the level in pixels
+	std::size_t Offset = 0;		// Offset of the level in Bytes
+	std::size_t Size = 0;		// Size of the level in bytes
+
+};
+
+/**
+ * @brief Makes a DDS four character code.
+ * @return Returns the code as it is stored in the file.
+ */
+constexpr std::uint32_t MakeFourCC(char A, char B, char C, char D) {
+	return (std::uint32_t)(unsigned char)A | ((std::uint32_t)(unsigned char)B << 8) | ((std::uint32_t)(unsigned char)C << 16) | ((std::uint32_t)(unsigned char)D << 24);
+
+}
+
+/**
+ * @struct TextureData
+ * @brief CPU side texture data with its whole mip chain, level 0 being the largest.
+ * @note The loaders only read, so they are safe to call on any thread.
+ */
+struct TextureData {
+	TextureFormat Format;				// Format of the data
+	int Width = 0;						// Width of level 0 in pixels
+	int Height = 0;						// Height of level 0 in pixels
+	std::vector<TextureLevel> Levels;	// The mip levels, largest first
+	std::vector<unsigned char> Bytes;	// All of the levels back to back
+
+	/**
+	 * @brief Checks if the data was loaded.
+	 * @return Returns a bool of whether there is something to upload.
+	 */
+	bool IsValid() const {
+		return Width > 0 && Height > 0 && !Levels.empty();
+
+	}
+
+	/**
+	 * @brief Gets the number of levels a full mip chain has.
+	 * @param Width Width of level 0.
+	 * @param Height Height of level 0.
+	 * @return Returns the level count, down to 1x1.
+	 */
+	static int GetFullLevelCount(int Width, int Height) {
+		int Count = 1;
+		while(Width > 1 || Height > 1) {
+			Width = std::max(1, Width / 2);
+			Height = std::max(1, Height / 2);
+			Count++;
+
+		}
+
+		return Count;
+
+	}
+
+	/**
+	 * @brief Makes texture data from RGBA8 pixels in memory.
+	 * @param Width Width in pixels.
+	 * @param Height Height in pixels.
+	 * @param Pixels Pointer to Width * Height * 4 bytes.
+	 * @return Returns TextureData with a single level. Mipmaps are generated on upload.
+	 */
+	static TextureData FromPixels(int Width, int Height, const unsigned char* Pixels) {
+		TextureData Data;
+		Data.Format = TextureFormat::Uncompressed(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4);
+		Data.Width = Width;
+		Data.Height = Height;
+
+		// Copying the pixels
+		std::size_t Size = Data.Format.GetLevelSize(Width, Height);
+		Data.Bytes.assign(Pixels, Pixels + Size);
+		Data.Levels.push_back({ Width, Height, 0, Size });
+
+		return Data;
+
+	}
+
+	/**
+	 * @brief Loads a texture file, picking the loader from the extension.
+	 * @param Path Path of a .dds or .ktx2 file.
+	 * @return Returns the loaded data, or empty data on failure.
+	 */
+	static TextureData LoadFromFile(const std::string& Path) {
+		// Getting the extension
+		std::string Extension = Path.substr(Path.find_last_of('.') + 1);
+		std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char C) { return (char)std::tolower(C); });
+
+		if(Extension == "dds") {
+			return LoadDDS(Path);
+		}
+
+		if(Extension == "ktx2") {
+			return LoadKTX2(Path);
+		}
+
+		SR_LOG_ERROR("TextureData: LoadFromFile(): %s is not a .dds or .ktx2 file.", Path.c_str());
+		return TextureData();
+
+	}
+
+	/**
+	 * @brief Loads a DDS file, including the DX10 header.
+	 * @param Path Path of the file.
+	 * @return Returns the loaded data, or empty data on failure.
+	 * @note Supports BC1-BC7 and 32 bit RGBA/BGRA. Cubemaps, volumes and arrays are not supported.
+	 */
+	static TextureData LoadDDS(const std::string& Path) {
+		std::vector<unsigned char> File;
+		if(!ReadFile(Path, File)) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s file does not exist.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Checking the magic and the header
+		if(File.size() < 128 || std::memcmp(File.data(), "DDS ", 4) != 0) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s is not a DDS file.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Reading the header
+		std::uint32_t Flags = ReadU32(File, 8);
+		std::uint32_t Height = ReadU32(File, 12);
+		std::uint32_t Width = ReadU32(File, 16);
+		std::uint32_t MipCount = (Flags & 0x20000) ? std::max<std::uint32_t>(1, ReadU32(File, 28)) : 1;
+		std::uint32_t PixelFlags = ReadU32(File, 80);
+		std::uint32_t FourCC = ReadU32(File, 84);
+		std::uint32_t BitCount = ReadU32(File, 88);
+		std::uint32_t RedMask = ReadU32(File, 92);
+		std::uint32_t Caps2 = ReadU32(File, 112);
+		std::size_t DataOffset = 128;
+
+		// Cubemaps and volumes
+		if(Caps2 & (0x200 | 0x200000)) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s is a cubemap or volume, which is not supported.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Checking the size, the mip count comes from the file so it is bounded by the full chain
+		if(Width == 0 || Height == 0 || Width > MaxSize || Height > MaxSize) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s has an invalid size of %ux%u.", Path.c_str(), Width, Height);
+			return TextureData();
+
+		}
+
+		if(MipCount > (std::uint32_t)GetFullLevelCount((int)Width, (int)Height)) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s has %u mip levels, more than a %ux%u texture can have.", Path.c_str(), MipCount, Width, Height);
+			return TextureData();
+
+		}
+
+		TextureData Data;
+		bool Known = true;
+
+		// Working out the format
+		if(PixelFlags & 0x4) {
+			switch(FourCC) {
+				case MakeFourCC('D', 'X', 'T', '1'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 8); break;
+				case MakeFourCC('D', 'X', 'T', '3'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 16); break;
+				case MakeFourCC('D', 'X', 'T', '5'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 16); break;
+				case MakeFourCC('A', 'T', 'I', '1'):
+				case MakeFourCC('B', 'C', '4', 'U'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_RED_RGTC1, 8); break;
+				case MakeFourCC('B', 'C', '4', 'S'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RED_RGTC1, 8); break;
+				case MakeFourCC('A', 'T', 'I', '2'):
+				case MakeFourCC('B', 'C', '5', 'U'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_RG_RGTC2, 16); break;
+				case MakeFourCC('B', 'C', '5', 'S'): Data.Format = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RG_RGTC2, 16); break;
+				case MakeFourCC('D', 'X', '1', '0'): {
+					// The DX10 header has the real format
+					if(File.size() < 148) {
+						Known = false;
+						break;
+
+					}
+
+					std::uint32_t DXGIFormat = ReadU32(File, 128);
+					std::uint32_t ArraySize = ReadU32(File, 140);
+					DataOffset = 148;
+
+					if(ArraySize > 1) {
+						SR_LOG_ERROR("TextureData: LoadDDS(): %s is an array, which is not supported.", Path.c_str());
+						return TextureData();
+
+					}
+
+					Known = FormatFromDXGI(DXGIFormat, Data.Format);
+					break;
+
+				}
+				default: Known = false; break;
+
+			}
+
+		} else if((PixelFlags & 0x40) && BitCount == 32) {
+			// Plain 32 bit, either RGBA or BGRA order
+			if(RedMask == 0x000000ff) {
+				Data.Format = TextureFormat::Uncompressed(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4);
+
+			} else if(RedMask == 0x00ff0000) {
+				Data.Format = TextureFormat::Uncompressed(GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, 4);
+
+			} else {
+				Known = false;
+
+			}
+
+		} else {
+			Known = false;
+
+		}
+
+		if(!Known) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s has an unsupported pixel format.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Laying out the levels, they are back to back after the header
+		Data.Width = (int)Width;
+		Data.Height = (int)Height;
+		std::size_t Offset = 0;
+		int LevelWidth = Data.Width;
+		int LevelHeight = Data.Height;
+		for(std::uint32_t Level = 0; Level < MipCount; Level++) {
+			std::size_t Size = Data.Format.GetLevelSize(LevelWidth, LevelHeight);
+			Data.Levels.push_back({ LevelWidth, LevelHeight, Offset, Size });
+			Offset += Size;
+
+			LevelWidth = std::max(1, LevelWidth / 2);
+			LevelHeight = std::max(1, LevelHeight / 2);
+
+		}
+
+		// Checking the file is big enough
+		if(Offset > File.size() - DataOffset) {
+			SR_LOG_ERROR("TextureData: LoadDDS(): %s is truncated.", Path.c_str());
+			return TextureData();
+
+		}
+
+		Data.Bytes.assign(File.begin() + DataOffset, File.begin() + DataOffset + Offset);
+		return Data;
+
+	}
+
+	/**
+	 * @brief Loads a KTX2 file.
+	 * @param Path Path of the file.
+	 * @return Returns the loaded data, or empty data on failure.
+	 * @note Supports BC1-BC7 and RGBA8. Supercompressed (Basis/Zstd) files, cubemaps, volumes and arrays are not supported.
+	 */
+	static TextureData LoadKTX2(const std::string& Path) {
+		static const unsigned char Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		std::vector<unsigned char> File;
+		if(!ReadFile(Path, File)) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s file does not exist.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Checking the identifier and the header
+		if(File.size() < 80 || std::memcmp(File.data(), Identifier, 12) != 0) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s is not a KTX2 file.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Reading the header
+		std::uint32_t VkFormat = ReadU32(File, 12);
+		std::uint32_t Width = ReadU32(File, 20);
+		std::uint32_t Height = ReadU32(File, 24);
+		std::uint32_t Depth = ReadU32(File, 28);
+		std::uint32_t LayerCount = ReadU32(File, 32);
+		std::uint32_t FaceCount = ReadU32(File, 36);
+		std::uint32_t LevelCount = std::max<std::uint32_t>(1, ReadU32(File, 40));
+		std::uint32_t Supercompression = ReadU32(File, 44);
+
+		if(Depth > 1 || LayerCount > 1 || FaceCount != 1) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s is a cubemap, volume or array, which is not supported.", Path.c_str());
+			return TextureData();
+
+		}
+
+		if(Supercompression != 0) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s is supercompressed, which is not supported.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// Checking the size, the level count comes from the file so it is bounded by the full chain
+		if(Width == 0 || Height == 0 || Width > MaxSize || Height > MaxSize) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s has an invalid size of %ux%u.", Path.c_str(), Width, Height);
+			return TextureData();
+
+		}
+
+		if(LevelCount > (std::uint32_t)GetFullLevelCount((int)Width, (int)Height)) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s has %u levels, more than a %ux%u texture can have.", Path.c_str(), LevelCount, Width, Height);
+			return TextureData();
+
+		}
+
+		TextureData Data;
+		if(!FormatFromVulkan(VkFormat, Data.Format)) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s has an unsupported format.", Path.c_str());
+			return TextureData();
+
+		}
+
+		// The level index is right after the header, 24 bytes per level
+		if((File.size() - 80) / 24 < LevelCount) {
+			SR_LOG_ERROR("TextureData: LoadKTX2(): %s is truncated.", Path.c_str());
+			return TextureData();
+
+		}
+
+		Data.Width = (int)Width;
+		Data.Height = (int)Height;
+
+		// Copying the levels into one block, largest first
+		int LevelWidth = Data.Width;
+		int LevelHeight = Data.Height;
+		for(std::uint32_t Level = 0; Level < LevelCount; Level++) {
+			std::size_t Entry = 80 + (std::size_t)Level * 24;
+			std::uint64_t FileOffset = ReadU64(File, Entry);
+			std::uint64_t FileLength = ReadU64(File, Entry + 8);
+			std::size_t Size = Data.Format.GetLevelSize(LevelWidth, LevelHeight);
+
+			// Comparing against what is left so a huge offset can not wrap around
+			if(FileLength < Size || FileOffset > File.size() || Size > File.size() - FileOffset) {
+				SR_LOG_ERROR("TextureData: LoadKTX2(): %s is truncated.", Path.c_str());
+				return TextureData();
+
+			}
+
+			Data.Levels.push_back({ LevelWidth, LevelHeight, Data.Bytes.size(), Size });
+			Data.Bytes.insert(Data.Bytes.end(), File.begin() + FileOffset, File.begin() + FileOffset + Size);
+
+			LevelWidth = std::max(1, LevelWidth / 2);
+			LevelHeight = std::max(1, LevelHeight / 2);
+
+		}
+
+		return Data;
+
+	}
+
+private:
+	static constexpr std::uint32_t MaxSize = 65536;	// Largest width or height the loaders accept
+
+	/**
+	 * @brief Reads a whole binary file.
+	 */
+	static bool ReadFile(const std::string& Path, std::vector<unsigned char>& Out) {
+		std::ifstream File(Path, std::ios::binary | std::ios::ate);
+		if(!File.is_open()) {
+			return false;
+		}
+
+		std::streamsize Size = File.tellg();
+		File.seekg(0, std::ios::beg);
+		Out.resize((std::size_t)Size);
+		return (bool)File.read((char*)Out.data(), Size);
+
+	}
+
+	/**
+	 * @brief Reads a little endian 32 bit int.
+	 */
+	static std::uint32_t ReadU32(const std::vector<unsigned char>& Bytes, std::size_t Offset) {
+		return (std::uint32_t)Bytes[Offset] | ((std::uint32_t)Bytes[Offset + 1] << 8) | ((std::uint32_t)Bytes[Offset + 2] << 16) | ((std::uint32_t)Bytes[Offset + 3] << 24);
+
+	}
+
+	/**
+	 * @brief Reads a little endian 64 bit int.
+	 */
+	static std::uint64_t ReadU64(const std::vector<unsigned char>& Bytes, std::size_t Offset) {
+		return (std::uint64_t)ReadU32(Bytes, Offset) | ((std::uint64_t)ReadU32(Bytes, Offset + 4) << 32);
+
+	}
+
+	/**
+	 * @brief Converts a DXGI_FORMAT from the DDS DX10 header.
+	 */
+	static bool FormatFromDXGI(std::uint32_t DXGIFormat, TextureFormat& Out) {
+		switch(DXGIFormat) {
+			case 28: Out = TextureFormat::Uncompressed(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4); return true;
+			case 29: Out = TextureFormat::Uncompressed(GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE, 4); return true;
+			case 87: Out = TextureFormat::Uncompressed(GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, 4); return true;
+			case 71: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 8); return true;
+			case 72: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 8); return true;
+			case 74: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 16); return true;
+			case 75: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, 16); return true;
+			case 77: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 16); return true;
+			case 78: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 16); return true;
+			case 80: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RED_RGTC1, 8); return true;
+			case 81: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RED_RGTC1, 8); return true;
+			case 83: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RG_RGTC2, 16); return true;
+			case 84: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RG_RGTC2, 16); return true;
+			case 95: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 16); return true;
+			case 96: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 16); return true;
+			case 98: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_BPTC_UNORM, 16); return true;
+			case 99: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 16); return true;
+			default: return false;
+
+		}
+
+	}
+
+	/**
+	 * @brief Converts a VkFormat from the KTX2 header.
+	 */
+	static bool FormatFromVulkan(std::uint32_t VkFormat, TextureFormat& Out) {
+		switch(VkFormat) {
+			case 37: Out = TextureFormat::Uncompressed(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4); return true;
+			case 43: Out = TextureFormat::Uncompressed(GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE, 4); return true;
+			case 131: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8); return true;
+			case 132: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 8); return true;
+			case 133: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 8); return true;
+			case 134: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 8); return true;
+			case 135: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 16); return true;
+			case 136: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, 16); return true;
+			case 137: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 16); return true;
+			case 138: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 16); return true;
+			case 139: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RED_RGTC1, 8); return true;
+			case 140: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RED_RGTC1, 8); return true;
+			case 141: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RG_RGTC2, 16); return true;
+			case 142: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SIGNED_RG_RGTC2, 16); return true;
+			case 143: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 16); return true;
+			case 144: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 16); return true;
+			case 145: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_RGBA_BPTC_UNORM, 16); return true;
+			case 146: Out = TextureFormat::BlockCompressed(GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 16); return true;
+			default: return false;
+
+		}
+
+	}
+
+};
+
+class TextureStreamerInstance;
+
+/**
+ * @class TextureInstance
+ * @brief A single immutable 2D texture.
+ * @note Storage is made with glTexStorage2D, so the size, format and level count can never change.
+ * @warning The renderer must be initialized before creating any textures.
+ */
+class TextureInstance {
+public:
+	TextureInstance() {}			// Default constructor
+
+	/**
+	 * @brief Constructor which creates the texture and uploads all of the data right away.
+	 * @param Data The texture data to upload.
+	 * @param GenerateMipmaps Whether to generate the rest of the mip chain if the data only has one level. Only works for uncompressed data.
+	 * @note For big textures, use a TextureStreamerInstance instead so the upload is spread over frames.
+	 */
+	TextureInstance(const TextureData& Data, bool GenerateMipmaps = true) {
+		Create(Data, GenerateMipmaps);
+
+	}
+
+	/**
+	 * @brief Constructor which creates the texture and uploads all of the data on a loader thread.
+	 * @param Loader Pointer to the loader which does the upload.
+	 * @param Data The texture data to upload. Kept alive by the loader until it is uploaded.
+	 * @param GenerateMipmaps Whether to generate the rest of the mip chain if the data only has one level. Only works for uncompressed data.
+	 * @note The texture does not bind until IsReady() returns true.
+	 */
+	TextureInstance(LoaderInstance* Loader, std::shared_ptr<TextureData> Data, bool GenerateMipmaps = true) {
+		Upload = Loader->Submit([this, Data, GenerateMipmaps]() {
+			Create(*Data, GenerateMipmaps);
+
+		});
+
+	}
+
+	/**
+	 * @brief Function which checks whether the texture can be used yet.
+	 * @return Returns a bool of whether the upload has finished. Always true when not made on a loader.
+	 */
+	bool IsReady() {
+		// Nothing in flight
+		if(!Upload) {
+			return true;
+
+		}
+
+		// Dropping the fence once it has signalled
+		if(Upload->IsReady()) {
+			Upload.reset();
+			return true;
+
+		}
+
+		return false;
+
+	}
+
+	/**
+	 * @brief Binds the texture to a texture unit.
+	 * @param Unit The texture unit, starting at 0.
+	 * @note Does nothing while a loader upload is in flight or before a streamed texture has any levels.
+	 */
+	void Bind(int Unit) {
+		// Waiting on the loader isnt an error, just not ready yet
+		if(!IsReady()) {
+			return;
+
+		}
+
+		// Guard checking
+		if(!TextureCreated) {
+			SR_LOG_ERROR("TextureInstance: Bind(): Texture has not been created.");
+			return;
+
+		}
+
+		// Streamed textures have nothing to sample until their first level arrives
+		if(BaseLevel >= LevelCount) {
+			return;
+
+		}
+
+		glActiveTexture(GL_TEXTURE0 + Unit);
+		glBindTexture(GL_TEXTURE_2D, ID);
+
+	}
+
+	/**
+	 * @brief Sets the filtering of the texture.
+	 * @param Linear Whether to filter linearly instead of picking the nearest texel.
+	 * @param Anisotropy Max anisotropy, 1 turns it off. Ignored if the driver doesnt support it.
+	 */
+	void SetFiltering(bool Linear, float Anisotropy = 1.0f) {
+		// Guard checking
+		if(!IsReady() || !TextureCreated) {
+			return;
+
+		}
+
+		glBindTexture(GL_TEXTURE_2D, ID);
+		if(LevelCount > 1) {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST);
+
+		} else {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, Linear ? GL_LINEAR : GL_NEAREST);
+
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, Linear ? GL_LINEAR : GL_NEAREST);
+
+		if(Anisotropy > 1.0f && glewIsSupported("GL_EXT_texture_filter_anisotropic")) {
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, Anisotropy);
+
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+	}
+
+	/**
+	 * @brief Function to get the OpenGL ID of the texture.
+	 * @return Returns the texture ID.
+	 */
+	unsigned int GetID() {
+		return ID;
+
+	}
+
+	/**
+	 * @brief Function to get the width of level 0.
+	 * @return Returns the width in pixels.
+	 */
+	int GetWidth() {
+		return Width;
+
+	}
+
+	/**
+	 * @brief Function to get the height of level 0.
+	 * @return Returns the height in pixels.
+	 */
+	int GetHeight() {
+		return Height;
+
+	}
+
+	/**
+	 * @brief Function to get the number of levels in the storage.
+	 * @return Returns the level count.
+	 */
+	int GetLevelCount() {
+		return LevelCount;
+
+	}
+
+	/**
+	 * @brief Function to get the largest level which has data.
+	 * @return Returns the level, or the level count if nothing has been uploaded yet.
+	 */
+	int GetBaseLevel() {
+		return BaseLevel;
+
+	}
+
+	/**
+	 * @brief Function to check if every level has data.
+	 * @return Returns a bool of whether the texture is fully loaded.
+	 */
+	bool IsFullyResident() {
+		return TextureCreated && BaseLevel == 0;
+
+	}
+
+	/**
+	 * @brief Function to get the size of the storage.
+	 * @return Returns the size of all levels in bytes.
+	 */
+	std::size_t GetMemorySize() {
+		return MemorySize;
+
+	}
+
+	/**
+	 * @brief Function which deletes the texture, taking it out of the streamer first if it was streamed.
+	 * @note Defined after TextureStreamerInstance, which it calls into.
+	 */
+	~TextureInstance();
+
+private:
+	friend class TextureStreamerInstance;
+
+	/**
+	 * @brief Makes the storage and uploads all of the data.
+	 * @param Data The texture data to upload.
+	 * @param GenerateMipmaps Whether to generate the rest of the mip chain if the data only has one level.
+	 */
+	void Create(const TextureData& Data, bool GenerateMipmaps) {
+		// Guard checking
+		if(!Data.IsValid()) {
+			SR_LOG_ERROR("TextureInstance: Create(): Texture data is not valid.");
+			return;
+
+		}
+
+		// Working out if the mips get generated
+		bool Generate = GenerateMipmaps && Data.Levels.size() == 1 && !Data.Format.Compressed;
+		int Levels = Generate ? TextureData::GetFullLevelCount(Data.Width, Data.Height) : (int)Data.Levels.size();
+
+		// Making the storage
+		Allocate(Data.Format, Data.Width, Data.Height, Levels);
+
+		// Uploading every level
+		for(int Level = 0; Level < (int)Data.Levels.size(); Level++) {
+			UploadLevel(Level, Data.Levels[Level], Data.Bytes.data() + Data.Levels[Level].Offset);
+
+		}
+
+		// Generating the rest
+		if(Generate) {
+			glGenerateMipmap(GL_TEXTURE_2D);
+
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Everything is there
+		BaseLevel = 0;
+
+	}
+
+	/**
+	 * @brief Makes the immutable storage and leaves the texture bound.
+	 * @param _Format Format of the texture.
+	 * @param _Width Width of level 0.
+	 * @param _Height Height of level 0.
+	 * @param Levels Number of levels.
+	 */
+	void Allocate(const TextureFormat& _Format, int _Width, int _Height, int Levels) {
+		Format = _Format;
+		Width = _Width;
+		Height = _Height;
+		LevelCount = Levels;
+		BaseLevel = Levels;
+
+		glGenTextures(1, &ID);
+		glBindTexture(GL_TEXTURE_2D, ID);
+
+		// Immutable storage when there is support, otherwise every level by hand
+		if(GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+			glTexStorage2D(GL_TEXTURE_2D, LevelCount, Format.InternalFormat, Width, Height);
+
+		} else {
+			int LevelWidth = Width;
+			int LevelHeight = Height;
+			for(int Level = 0; Level < LevelCount; Level++) {
+				if(Format.Compressed) {
+					glCompressedTexImage2D(GL_TEXTURE_2D, Level, Format.InternalFormat, LevelWidth, LevelHeight, 0, (GLsizei)Format.GetLevelSize(LevelWidth, LevelHeight), NULL);
+
+				} else {
+					glTexImage2D(GL_TEXTURE_2D, Level, Format.InternalFormat, LevelWidth, LevelHeight, 0, Format.Format, Format.Type, NULL);
+
+				}
+
+				LevelWidth = std::max(1, LevelWidth / 2);
+				LevelHeight = std::max(1, LevelHeight / 2);
+
+			}
+
+		}
+
+		// Adding up the memory
+		MemorySize = 0;
+		int LevelWidth = Width;
+		int LevelHeight = Height;
+		for(int Level = 0; Level < LevelCount; Level++) {
+			MemorySize += Format.GetLevelSize(LevelWidth, LevelHeight);
+			LevelWidth = std::max(1, LevelWidth / 2);
+			LevelHeight = std::max(1, LevelHeight / 2);
+
+		}
+		MemoryTrackerInstance::Get().Track(MemoryCategory::Texture, ID, MemorySize, "TextureInstance");
+
+		// Defaults
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, LevelCount - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, LevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		TextureCreated = true;
+
+	}
+
+	/**
+	 * @brief Uploads one level to the bound texture.
+	 * @param Level The level to upload into.
+	 * @param Info The size of the level.
+	 * @param Pixels Pointer to the data, or an offset into the bound pixel unpack buffer.
+	 */
+	void UploadLevel(int Level, const TextureLevel& Info, const void* Pixels) {
+		if(Format.Compressed) {
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, Level, 0, 0, Info.Width, Info.Height, Format.InternalFormat, (GLsizei)Info.Size, Pixels);
+
+		} else {
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, Level, 0, 0, Info.Width, Info.Height, Format.Format, Format.Type, Pixels);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		}
+
+	}
+
+	unsigned int ID = 0;				// The OpenGL ID of the texture
+	bool TextureCreated = false;		// Bool guard determining whether the texture has been created
+	TextureFormat Format;				// Format of the texture
+	int Width = 0;						// Width of level 0
+	int Height = 0;						// Height of level 0
+	int LevelCount = 0;					// Number of levels in the storage
+	int BaseLevel = 0;					// Largest level with data
+	std::size_t MemorySize = 0;			// Size of the storage in bytes
+	std::shared_ptr<UploadFence> Upload;	// Fence of the loader upload, null when not made on a loader
+	TextureStreamerInstance* Streamer = nullptr;	// Streamer the texture was made by, null when not streamed
+
+};
+
+/**
+ * @class TextureStreamerInstance
+ * @brief Uploads textures progressively through a pixel buffer object, smallest mips first, spread over frames.
+ * @note Textures do not bind until their smallest level has arrived. After that GL_TEXTURE_BASE_LEVEL follows the largest level that has arrived, so they sharpen as they stream in.
+ * @note The memory budget caps the storage of all streamed textures. A texture that doesnt fit gets its largest levels dropped until it does.
+ * @note The pixel buffer is orphaned before every write so the CPU never waits for the GPU to finish reading the last one.
+ */
+class TextureStreamerInstance {
+public:
+	/**
+	 * @brief Constructor for the streamer.
+	 * @param _BytesPerFrame Max bytes uploaded per Update(). At least one level is always uploaded per frame.
+	 * @param _MemoryBudget Max bytes of texture storage for all streamed textures, 0 is unlimited.
+	 * @warning The renderer must be initialized before creating this.
+	 */
+	TextureStreamerInstance(std::size_t _BytesPerFrame, std::size_t _MemoryBudget = 0) : BytesPerFrame(_BytesPerFrame), MemoryBudget(_MemoryBudget) {
+		glGenBuffers(1, &PBO);
+
+	}
+
+	/**
+	 * @brief Makes the storage for a texture and queues its data for streaming.
+	 * @param Texture The texture to stream into, must not be created yet.
+	 * @param Data The data to stream. Kept alive by the streamer until it is uploaded.
+	 * @return Returns a bool of whether the texture was queued.
+	 * @note The texture takes itself out of the streamer when it is deleted.
+	 */
+	bool Stream(TextureInstance* Texture, std::shared_ptr<TextureData> Data) {
+		// Guard checking
+		if(!Texture || !Data || !Data->IsValid()) {
+			SR_LOG_ERROR("TextureStreamerInstance: Stream(): Texture or data is not valid.");
+			return false;
+
+		}
+
+		if(Texture->TextureCreated) {
+			SR_LOG_ERROR("TextureStreamerInstance: Stream(): Texture has already been created.");
+			return false;
+
+		}
+
+		// Dropping the largest levels until the chain fits in the budget
+		int FirstLevel = 0;
+		int LevelCount = (int)Data->Levels.size();
+		if(MemoryBudget > 0) {
+			std::size_t Available = MemoryBudget > ResidentBytes ? MemoryBudget - ResidentBytes : 0;
+			while(FirstLevel < LevelCount - 1 && GetChainSize(*Data, FirstLevel) > Available) {
+				FirstLevel++;
+
+			}
+
+		}
+
+		if(FirstLevel > 0) {
+			SR_LOG_WARNING("TextureStreamerInstance: Stream(): Over memory budget, dropping %d mip levels.", FirstLevel);
+
+		}
+
+		// Making the storage, the base level starts on the smallest level since that arrives first
+		const TextureLevel& Top = Data->Levels[FirstLevel];
+		Texture->Allocate(Data->Format, Top.Width, Top.Height, LevelCount - FirstLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, Texture->LevelCount - 1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		ResidentBytes += Texture->MemorySize;
+		Texture->Streamer = this;
+		Textures.push_back(Texture);
+
+		// Queueing the levels, mip tail first
+		for(int Level = LevelCount - 1; Level >= FirstLevel; Level--) {
+			Pending.push_back({ Texture, Data, Level, Level - FirstLevel });
+			PendingBytes += Data->Levels[Level].Size;
+
+		}
+
+		return true;
+
+	}
+
+	/**
+	 * @brief Uploads queued levels up to the per frame budget.
+	 * @note Call once per frame on the render thread.
+	 */
+	void Update() {
+		std::size_t Uploaded = 0;
+
+		while(!Pending.empty()) {
+			PendingLevel& Next = Pending.front();
+			const TextureLevel& Info = Next.Data->Levels[Next.SourceLevel];
+
+			// Stopping at the budget, but always doing at least one level so big levels still get through
+			if(Uploaded > 0 && Uploaded + Info.Size > BytesPerFrame) {
+				break;
+
+			}
+
+			// Orphaning the pixel buffer and writing the level into it
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, Info.Size, NULL, GL_STREAM_DRAW);
+			MemoryTrackerInstance::Get().Track(MemoryCategory::Buffer, PBO, Info.Size, "TextureStreamerInstance pixel buffer");
+			void* Mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, Info.Size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+			// Leaving the level queued to try again next frame, later levels cant go first or BASE_LEVEL would skip it
+			if(!Mapped) {
+				SR_LOG_ERROR("TextureStreamerInstance: Update(): Could not map the pixel buffer.");
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				break;
+
+			}
+
+			std::memcpy(Mapped, Next.Data->Bytes.data() + Info.Offset, Info.Size);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+			// Copying from the pixel buffer, this returns without waiting on the transfer
+			glBindTexture(GL_TEXTURE_2D, Next.Texture->ID);
+			Next.Texture->UploadLevel(Next.TargetLevel, Info, (const void*)0);
+
+			// Letting the texture sample down to this level
+			Next.Texture->BaseLevel = Next.TargetLevel;
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, Next.TargetLevel);
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			Uploaded += Info.Size;
+			PendingBytes -= Info.Size;
+			Pending.pop_front();
+
+		}
+
+	}
+
+	/**
+	 * @brief Removes a texture's queued levels and gives back its memory budget.
+	 * @param Texture The texture to stop streaming.
+	 * @note Called by the texture when it is deleted, so only needed to free the budget of a texture that is kept.
+	 */
+	void Cancel(TextureInstance* Texture) {
+		// Guard checking
+		auto Found = std::find(Textures.begin(), Textures.end(), Texture);
+		if(Found == Textures.end()) {
+			return;
+
+		}
+		Textures.erase(Found);
+		Texture->Streamer = nullptr;
+
+		// Removing the queued levels
+		for(auto It = Pending.begin(); It != Pending.end();) {
+			if(It->Texture == Texture) {
+				PendingBytes -= It->Data->Levels[It->SourceLevel].Size;
+				It = Pending.erase(It);
+
+			} else {
+				++It;
+
+			}
+
+		}
+
+		// Giving back the budget
+		ResidentBytes -= std::min(ResidentBytes, Texture->MemorySize);
+
+	}
+
+	/**
+	 * @brief Function to get the storage used by streamed textures.
+	 * @return Returns the size in bytes.
+	 */
+	std::size_t GetResidentBytes() {
+		return ResidentBytes;
+
+	}
+
+	/**
+	 * @brief Function to get how much is still waiting to be uploaded.
+	 * @return Returns the size in bytes.
+	 */
+	std::size_t GetPendingBytes() {
+		return PendingBytes;
+
+	}
+
+	/**
+	 * @brief Function which deletes the pixel buffer.
+	 */
+	~TextureStreamerInstance() {
+		// Letting go of the textures, they outlive the streamer fine
+		for(TextureInstance* Texture : Textures) {
+			Texture->Streamer = nullptr;
+
+		}
+
+		MemoryTrackerInstance::Get().Untrack(MemoryCategory::Buffer, PBO);
+		glDeleteBuffers(1, &PBO);
+
+	}
+
+private:
+	/**
+	 * @struct PendingLevel
+	 * @brief A level waiting to be uploaded.
+	 */
+	struct PendingLevel {
+		TextureInstance* Texture;			// Texture to upload into
+		std::shared_ptr<TextureData> Data;	// Data to upload from
+		int SourceLevel;					// Level in Data
+		int TargetLevel;					// Level in the texture, differs from SourceLevel when levels were dropped
+
+	};
+
+	/**
+	 * @brief Adds up the size of a mip chain from a level down.
+	 */
+	static std::size_t GetChainSize(const TextureData& Data, int FirstLevel) {
+		std::size_t Size = 0;
+		for(int Level = FirstLevel; Level < (int)Data.Levels.size(); Level++) {
+			Size += Data.Levels[Level].Size;
+
+		}
+
+		return Size;
+
+	}
+
+	unsigned int PBO = 0;				// The pixel unpack buffer
+	std::deque<PendingLevel> Pending;	// Levels waiting to be uploaded, in order
+	std::vector<TextureInstance*> Textures;	// Textures made by Stream() which still count towards the budget
+	std::size_t BytesPerFrame;			// Upload budget per frame
+	std::size_t MemoryBudget;			// Storage budget, 0 is unlimited
+	std::size_t ResidentBytes = 0;		// Storage used by streamed textures
+	std::size_t PendingBytes = 0;		// Bytes still to upload
+
+};
+
+inline TextureInstance::~TextureInstance() {
+	// Taking it out of the streamer so no queued level points at it
+	if(Streamer) {
+		Streamer->Cancel(this);
+
+	}
+
+	// Waiting out an upload on the loader, it uses this
+	if(Upload) {
+		Upload->Wait();
+
+	}
+
+	// Guard checking
+	if(!TextureCreated) {
+		return;
+
+	}
+
+	MemoryTrackerInstance::Get().Untrack(MemoryCategory::Texture, ID);
+	glDeleteTextures(1, &ID);
+
+}
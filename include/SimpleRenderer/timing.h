@@ -0,0 +1,225 @@
+/**
+ * @file timing.h
+ * @brief Contains the frame timer, which does frame limiting and keeps track of frame times.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct FrameTimeStats
+ * @brief Statistics over the frame time history, all times are in milliseconds.
+ */
+struct FrameTimeStats {
+	int SampleCount = 0;		// Number of frames the stats were made from.
+	double Average = 0.0;		// Average frame time.
+	double Minimum = 0.0;		// Shortest frame time.
+	double Maximum = 0.0;		// Longest frame time.
+	double Percentile50 = 0.0;	// Median frame time.
+	double Percentile95 = 0.0;	// 95th percentile frame time.
+	double Percentile99 = 0.0;	// 99th percentile frame time.
+
+};
+
+/**
+ * @class FrameTimerInstance
+ * @brief A class which limits the frame rate and stores a rolling history of frame times.
+ * @note The limiter sleeps for most of the wait and only spins for the last bit, so it does not burn a whole core.
+ */
+class FrameTimerInstance {
+public:
+	/**
+	 * @brief Constructor for the frame timer.
+	 * @param _HistorySize The number of frame times kept in the rolling history.
+	 */
+	FrameTimerInstance(int _HistorySize = 240) : HistorySize(std::max(_HistorySize, 1)) {
+		// Making space for the history so nothing gets allocated per frame
+		History.resize(HistorySize);
+		SortScratch.reserve(HistorySize);
+
+		// Starting the clock
+		LastFrame = Clock::now();
+		NextDeadline = LastFrame;
+
+	}
+
+	/**
+	 * @brief Sets the frame rate the limiter caps to.
+	 * @param FramesPerSecond The max frames per second. 0 or less disables the limiter.
+	 */
+	void SetTargetFrameRate(double FramesPerSecond) {
+		// Disabling
+		if(FramesPerSecond <= 0.0) {
+			FramePeriod = Clock::duration::zero();
+			return;
+
+		}
+
+		// Setting the period and restarting the deadlines from now
+		FramePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / FramesPerSecond));
+		NextDeadline = Clock::now();
+
+	}
+
+	/**
+	 * @brief Function to get the target frame rate.
+	 * @return Returns the target frame rate, or 0 if the limiter is disabled.
+	 */
+	double GetTargetFrameRate() {
+		if(FramePeriod == Clock::duration::zero()) {
+			return 0.0;
+		}
+
+		return 1.0 / std::chrono::duration<double>(FramePeriod).count();
+
+	}
+
+	/**
+	 * @brief Blocks until the next frame deadline if the limiter is enabled.
+	 * @note Sleeps until the deadline minus the spin margin, then spins the rest of the way.
+	 */
+	void WaitForNextFrame() {
+		// Returning if the limiter is off
+		if(FramePeriod == Clock::duration::zero()) {
+			return;
+
+		}
+
+		// Moving the deadline forward one period
+		NextDeadline += FramePeriod;
+
+		// If we fell more than a frame behind, dont try to catch up by running frames back to back
+		Clock::time_point Now = Clock::now();
+		if(Now > NextDeadline + FramePeriod) {
+			NextDeadline = Now;
+			return;
+
+		}
+
+		// Sleeping for the coarse part of the wait
+		Clock::duration Remaining = NextDeadline - Now;
+		if(Remaining > SpinMargin) {
+			Clock::time_point WakeTarget = NextDeadline - SpinMargin;
+			std::this_thread::sleep_until(WakeTarget);
+
+			// Adjusting the spin margin to how much the OS overslept, so the spin is only as long as it needs to be
+			Clock::duration Overshoot = Clock::now() - WakeTarget;
+			Clock::duration Wanted = std::clamp(Overshoot * 2, MinSpinMargin, MaxSpinMargin);
+			SpinMargin = (SpinMargin * 7 + Wanted) / 8;
+
+		}
+
+		// Spinning for the precise part of the wait
+		while(Clock::now() < NextDeadline) {
+			std::this_thread::yield();
+
+		}
+
+	}
+
+	/**
+	 * @brief Records the time since the last call as a frame time.
+	 * @note Should be called once per frame, WindowInstance.FinishFrame() does this.
+	 */
+	void MarkFrame() {
+		// Getting the frame time
+		Clock::time_point Now = Clock::now();
+		LastFrameTime = std::chrono::duration<double, std::milli>(Now - LastFrame).count();
+		LastFrame = Now;
+
+		// Writing it into the ring
+		History[HistoryHead] = LastFrameTime;
+		HistoryHead = (HistoryHead + 1) % HistorySize;
+		SampleCount = std::min(SampleCount + 1, HistorySize);
+
+	}
+
+	/**
+	 * @brief Function to get the last frame time.
+	 * @return Returns the last frame time in milliseconds.
+	 */
+	double GetLastFrameTime() {
+		return LastFrameTime;
+
+	}
+
+	/**
+	 * @brief Calculates stats over the frame time history.
+	 * @return Returns a FrameTimeStats, all zero if no frames have been recorded.
+	 */
+	FrameTimeStats GetStats() {
+		FrameTimeStats Stats;
+
+		// Returning empty stats if there is nothing
+		if(SampleCount == 0) {
+			return Stats;
+
+		}
+
+		// Copying and sorting the history
+		SortScratch.assign(History.begin(), History.begin() + SampleCount);
+		std::sort(SortScratch.begin(), SortScratch.end());
+
+		// Getting the average
+		double Sum = 0.0;
+		for(double Time : SortScratch) {
+			Sum += Time;
+		}
+
+		// Filling in the stats
+		Stats.SampleCount = SampleCount;
+		Stats.Average = Sum / SampleCount;
+		Stats.Minimum = SortScratch.front();
+		Stats.Maximum = SortScratch.back();
+		Stats.Percentile50 = PercentileOfSorted(0.50);
+		Stats.Percentile95 = PercentileOfSorted(0.95);
+		Stats.Percentile99 = PercentileOfSorted(0.99);
+
+		return Stats;
+
+	}
+
+	/**
+	 * @brief Clears the frame time history.
+	 */
+	void ResetHistory() {
+		HistoryHead = 0;
+		SampleCount = 0;
+		LastFrame = Clock::now();
+
+	}
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * @brief Gets a percentile from SortScratch, which must already be sorted.
+	 * @param Fraction The percentile, from 0 to 1.
+	 */
+	double PercentileOfSorted(double Fraction) {
+		// Nearest rank
+		int Index = (int)(Fraction * (SampleCount - 1) + 0.5);
+		return SortScratch[std::clamp(Index, 0, SampleCount - 1)];
+
+	}
+
+	Clock::time_point LastFrame;						// When the last frame was marked
+	Clock::time_point NextDeadline;						// When the limiter lets the next frame through
+	Clock::duration FramePeriod = Clock::duration::zero();	// The target frame period, zero is unlimited
+
+	const Clock::duration MinSpinMargin = std::chrono::microseconds(200);	// Smallest spin at the end of a wait
+	const Clock::duration MaxSpinMargin = std::chrono::milliseconds(4);		// Largest spin at the end of a wait
+	Clock::duration SpinMargin = std::chrono::milliseconds(1);				// Current spin at the end of a wait
+
+	std::vector<double> History;		// Ring of frame times in milliseconds
+	std::vector<double> SortScratch;	// Scratch space for sorting the history
+	int HistorySize;					// Size of the ring
+	int HistoryHead = 0;				// Next index to write in the ring
+	int SampleCount = 0;				// Number of valid frame times in the ring
+	double LastFrameTime = 0.0;			// The last frame time in milliseconds
+
+};
@@ -0,0 +1,262 @@
+/**
+ * @file vertex.h
+ * @brief Contains vertex formats, which describe an interleaved vertex struct at compile time.
+ * @note A format is a vertex struct plus a list of attributes, e.g VertexFormat<MyVertex, SR_ATTRIBUTE(MyVertex, Position, 0), SR_ATTRIBUTE(MyVertex, Normal, 1)>.
+ * @note The attribute setup is unrolled at compile time, nothing about the layout is looked at while running.
+ * @note On GL 4.3+ (or with ARB_vertex_attrib_binding) every object with the same format shares one VAO, only the buffers are swapped between draws.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+/**
+ * @struct VertexAttributeLayout
+ * @brief A single attribute of a format, as plain data so it can be stored and written to captures.
+ */
+struct VertexAttributeLayout {
+	unsigned int Location = 0;		// Attribute location in the shader
+	int Components = 0;				// Number of components, 1 to 4
+	GLenum Type = GL_FLOAT;			// OpenGL type of each component
+	bool Normalized = false;		// Whether integers are turned into 0-1 or -1-1 floats
+	bool Integer = false;			// Whether the shader reads it as an int, i.e an integer type that isnt normalized
+	std::size_t Offset = 0;			// Offset into the vertex in bytes
+
+	bool operator==(const VertexAttributeLayout&) const = default;	// Same attribute if every field matches
+
+};
+
+/**
+ * @brief Finds the attribute at a location in a layout.
+ * @param Layout Pointer to the attributes.
+ * @param Count Number of attributes.
+ * @param Location Attribute location in the shader.
+ * @return Returns a pointer to the attribute, or nullptr if nothing is at the location.
+ */
+inline const VertexAttributeLayout* FindVertexAttribute(const VertexAttributeLayout* Layout, int Count, unsigned int Location) {
+	for(int Index = 0; Index < Count; Index++) {
+		if(Layout[Index].Location == Location) {
+			return &Layout[Index];
+
+		}
+
+	}
+
+	return nullptr;
+
+}
+
+/**
+ * @brief Gets the size of one component of an attribute type.
+ * @param Type OpenGL type of the component.
+ * @return Returns the size in bytes, or 0 if the type is not one VertexTypeTraits supports.
+ */
+inline std::size_t GetVertexTypeSize(GLenum Type) {
+	switch(Type) {
+		case GL_BYTE:
+		case GL_UNSIGNED_BYTE: return 1;
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT: return 2;
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT: return 4;
+		default: return 0;
+
+	}
+
+}
+
+/**
+ * @struct VertexTypeTraits
+ * @brief Maps a C++ member type to its component count and OpenGL type.
+ * @note Only the types below are supported, anything else fails to compile.
+ */
+template<typename Type>
+struct VertexTypeTraits;
+
+#define SR_VERTEX_TYPE(CType, Count, GLType) \
+	template<> struct VertexTypeTraits<CType> { \
+		static constexpr int Components = Count; \
+		static constexpr GLenum Type = GLType; \
+	};
+
+SR_VERTEX_TYPE(float, 1, GL_FLOAT)
+SR_VERTEX_TYPE(glm::vec2, 2, GL_FLOAT)
+SR_VERTEX_TYPE(glm::vec3, 3, GL_FLOAT)
+SR_VERTEX_TYPE(glm::vec4, 4, GL_FLOAT)
+SR_VERTEX_TYPE(int, 1, GL_INT)
+SR_VERTEX_TYPE(glm::ivec2, 2, GL_INT)
+SR_VERTEX_TYPE(glm::ivec3, 3, GL_INT)
+SR_VERTEX_TYPE(glm::ivec4, 4, GL_INT)
+SR_VERTEX_TYPE(unsigned int, 1, GL_UNSIGNED_INT)
+SR_VERTEX_TYPE(glm::uvec2, 2, GL_UNSIGNED_INT)
+SR_VERTEX_TYPE(glm::uvec3, 3, GL_UNSIGNED_INT)
+SR_VERTEX_TYPE(glm::uvec4, 4, GL_UNSIGNED_INT)
+SR_VERTEX_TYPE(glm::u8vec4, 4, GL_UNSIGNED_BYTE)
+SR_VERTEX_TYPE(glm::i8vec4, 4, GL_BYTE)
+SR_VERTEX_TYPE(glm::u16vec2, 2, GL_UNSIGNED_SHORT)
+SR_VERTEX_TYPE(glm::u16vec4, 4, GL_UNSIGNED_SHORT)
+SR_VERTEX_TYPE(glm::i16vec2, 2, GL_SHORT)
+
+#undef SR_VERTEX_TYPE
+
+/**
+ * @struct VertexAttribute
+ * @brief A single attribute of a vertex struct. Use SR_ATTRIBUTE or SR_ATTRIBUTE_NORMALIZED instead of writing this out.
+ * @tparam _Location Attribute location in the shader.
+ * @tparam Type C++ type of the member.
+ * @tparam _Offset Offset of the member in bytes.
+ * @tparam _Normalized Whether an integer member is read as a normalized float, e.g colors in a u8vec4.
+ */
+template<unsigned int _Location, typename Type, std::size_t _Offset, bool _Normalized = false>
+struct VertexAttribute {
+	typedef VertexTypeTraits<Type> Traits;
+
+	static_assert(!_Normalized || Traits::Type != GL_FLOAT, "VertexAttribute: Only integer types can be normalized.");
+
+	static constexpr std::size_t Size = sizeof(Type);		// Size of the member in bytes
+	static constexpr VertexAttributeLayout Layout = { _Location, Traits::Components, Traits::Type, _Normalized, Traits::Type != GL_FLOAT && !_Normalized, _Offset };
+
+	/**
+	 * @brief Points the attribute at the bound GL_ARRAY_BUFFER, the pre 4.3 way.
+	 * @param Stride Size of the vertex in bytes.
+	 */
+	static void SetupPointer(GLsizei Stride) {
+		glEnableVertexAttribArray(_Location);
+		if constexpr(Layout.Integer) {
+			glVertexAttribIPointer(_Location, Traits::Components, Traits::Type, Stride, (void*)_Offset);
+
+		} else {
+			glVertexAttribPointer(_Location, Traits::Components, Traits::Type, _Normalized ? GL_TRUE : GL_FALSE, Stride, (void*)_Offset);
+
+		}
+
+	}
+
+	/**
+	 * @brief Sets the attribute format and ties it to a buffer binding, so the buffer can be swapped without touching the format.
+	 * @param Binding The vertex buffer binding index.
+	 */
+	static void SetupFormat(unsigned int Binding) {
+		glEnableVertexAttribArray(_Location);
+		if constexpr(Layout.Integer) {
+			glVertexAttribIFormat(_Location, Traits::Components, Traits::Type, (unsigned int)_Offset);
+
+		} else {
+			glVertexAttribFormat(_Location, Traits::Components, Traits::Type, _Normalized ? GL_TRUE : GL_FALSE, (unsigned int)_Offset);
+
+		}
+		glVertexAttribBinding(_Location, Binding);
+
+	}
+
+};
+
+/**
+ * @brief Makes a VertexAttribute from a member of a vertex struct.
+ * @param Struct The vertex struct.
+ * @param Member Name of the member.
+ * @param Location Attribute location in the shader.
+ */
+#define SR_ATTRIBUTE(Struct, Member, Location) VertexAttribute<Location, decltype(Struct::Member), offsetof(Struct, Member)>
+
+/**
+ * @brief Makes a normalized VertexAttribute from an integer member of a vertex struct.
+ */
+#define SR_ATTRIBUTE_NORMALIZED(Struct, Member, Location) VertexAttribute<Location, decltype(Struct::Member), offsetof(Struct, Member), true>
+
+/**
+ * @struct VertexFormat
+ * @brief An interleaved vertex struct and its attributes.
+ * @tparam Vertex The vertex struct, which must be standard layout.
+ * @tparam Attributes The VertexAttributes of the struct.
+ * @note Pass it to ObjectInstance.CreateVAO<Format>().
+ * @warning The shared VAO is made in the context current on first use, and lives until the program exits.
+ */
+template<typename Vertex, typename... Attributes>
+struct VertexFormat {
+	typedef Vertex VertexType;
+
+	static_assert(sizeof...(Attributes) > 0, "VertexFormat: Needs at least one attribute.");
+	static_assert(std::is_standard_layout_v<Vertex>, "VertexFormat: Vertex must be standard layout for offsetof.");
+	static_assert(((Attributes::Layout.Offset + Attributes::Size <= sizeof(Vertex)) && ...), "VertexFormat: Attribute is outside of the vertex.");
+
+	static constexpr GLsizei Stride = sizeof(Vertex);						// Size of the vertex in bytes
+	static constexpr int AttributeCount = sizeof...(Attributes);			// Number of attributes
+	static constexpr VertexAttributeLayout Layout[] = { Attributes::Layout... };	// Attributes as plain data
+
+	/**
+	 * @brief Checks that no two attributes use the same location.
+	 */
+	static constexpr bool HasUniqueLocations() {
+		for(int First = 0; First < AttributeCount; First++) {
+			for(int Second = First + 1; Second < AttributeCount; Second++) {
+				if(Layout[First].Location == Layout[Second].Location) {
+					return false;
+
+				}
+
+			}
+
+		}
+
+		return true;
+
+	}
+
+	static_assert(HasUniqueLocations(), "VertexFormat: Two attributes use the same location.");
+
+	/**
+	 * @brief Checks if the context can use separate formats and a shared VAO.
+	 * @return Returns a bool of whether GL 4.3 or ARB_vertex_attrib_binding is there.
+	 */
+	static bool SupportsSharedVAO() {
+		return GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding;
+
+	}
+
+	/**
+	 * @brief Points every attribute at the bound GL_ARRAY_BUFFER, for a VAO of its own.
+	 */
+	static void SetupPointers() {
+		(Attributes::SetupPointer(Stride), ...);
+
+	}
+
+	/**
+	 * @brief Gets the VAO shared by every object of this format, making it the first time.
+	 * @return Returns the VAO. Bind the vertex buffer to binding 0 and the index buffer after binding it.
+	 */
+	static unsigned int GetSharedVAO() {
+		static unsigned int SharedVAO = CreateSharedVAO();
+		return SharedVAO;
+
+	}
+
+private:
+	/**
+	 * @brief Makes the shared VAO, with every format tied to binding 0.
+	 */
+	static unsigned int CreateSharedVAO() {
+		unsigned int VAO;
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		(Attributes::SetupFormat(0), ...);
+		glBindVertexArray(0);
+		return VAO;
+
+	}
+
+};
+
+/**
+ * @brief The format CreateVAO uses for plain glm::vec3 positions at location 0.
+ */
+typedef VertexFormat<glm::vec3, VertexAttribute<0, glm::vec3, 0>> PositionVertexFormat;
@@ -8,6 +8,9 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <SimpleRenderer/log.h>
+#include <SimpleRenderer/timing.h>
+
 /**
  * @class WindowInstance
  * @brief A class representing a single window.
@@ -19,14 +22,16 @@ public:
 	/**
 	 * @brief A constructor which creates a window and initializes the GLFW context.
 	 * @param Parameters A WindowInstanceParameters which contains all data for the window.
+	 * @param Visible Whether the window is shown. Hidden windows still have a working context, e.g for replaying captures headless.
 	 */
-	WindowInstance(const char* _Title, int _Width, int _Height, int VersionMajor, int VersionMinor) : Title(_Title), Width(_Width), Height(_Height) {
+	WindowInstance(const char* _Title, int _Width, int _Height, int VersionMajor, int VersionMinor, bool Visible = true) : Title(_Title), Width(_Width), Height(_Height) {
 		// Prepping window creation
 		glfwInit();
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, VersionMajor);
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, VersionMinor);
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, Visible ? GLFW_TRUE : GLFW_FALSE);
 		
 		// Creating window
 		Window = glfwCreateWindow(Width, Height,Title, NULL, NULL);
@@ -36,7 +41,7 @@ public:
 		
 		// Checking for failure
 		if(!Window) {
-			std::cout << "Error: WindowInstance: Constructor: Window creation failed.\n";
+			SR_LOG_ERROR("WindowInstance: Constructor: Window creation failed.");
 			return;
 			
 		}
@@ -47,9 +52,12 @@ public:
 		// Doing context
 		glfwMakeContextCurrent(Window);
 		
+		// Using the framebuffer size instead of the window size, they differ on high DPI screens
+		glfwGetFramebufferSize(Window, &Width, &Height);
+		
 		// Initialzing glew
 		if(glewInit() != GLEW_OK) {
-			std::cout << "Error: WindowInstance: Constructor: GLEW init failed.\n";
+			SR_LOG_ERROR("WindowInstance: Constructor: GLEW init failed.");
 			return;
 			
 		}
@@ -100,8 +108,94 @@ public:
 		
 		// Doing end frame stuff
 		glfwPollEvents();
+		
+		// Checking for resizes, done by polling so the window user pointer stays free for the camera
+		int NewWidth, NewHeight;
+		glfwGetFramebufferSize(Window, &NewWidth, &NewHeight);
+		Resized = (NewWidth != Width || NewHeight != Height) && NewWidth > 0 && NewHeight > 0;
+		if(Resized) {
+			Width = NewWidth;
+			Height = NewHeight;
+			
+		}
+		
+		// Holding the frame back if there is a frame rate limit
+		FrameTimer.WaitForNextFrame();
+		
 		glfwSwapBuffers(Window);
 		
+		// Recording the frame time
+		FrameTimer.MarkFrame();
+		
+	}
+	
+	/**
+	 * @brief Sets the swap interval, i.e vsync.
+	 * @param Interval The number of vblanks to wait before swapping. 0 disables vsync.
+	 * @param Adaptive Whether to use adaptive vsync, which swaps immediately if a frame is late instead of waiting another vblank.
+	 * @note If adaptive vsync is not supported by the driver, regular vsync is used.
+	 */
+	void SetSwapInterval(int Interval, bool Adaptive = false) {
+		// Returning if the window doesnt exist.
+		if(!Window) {
+			return;
+			
+		}
+		
+		// Swap interval applies to the current context
+		glfwMakeContextCurrent(Window);
+		
+		// Adaptive vsync is a negative interval, but only if the extension is there
+		if(Adaptive && Interval > 0) {
+			if(glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+				Interval = -Interval;
+				
+			} else {
+				SR_LOG_WARNING("WindowInstance: SetSwapInterval(): Adaptive vsync is not supported, using regular vsync.");
+				
+			}
+			
+		}
+		
+		glfwSwapInterval(Interval);
+		SwapInterval = Interval;
+		
+	}
+	
+	/**
+	 * @brief Function to get the swap interval.
+	 * @return Returns the swap interval. Negative means adaptive vsync.
+	 */
+	int GetSwapInterval() {
+		return SwapInterval;
+		
+	}
+	
+	/**
+	 * @brief Caps the frame rate using the frame limiter, independent of vsync.
+	 * @param FramesPerSecond The max frames per second. 0 or less removes the cap.
+	 */
+	void SetFrameRateLimit(double FramesPerSecond) {
+		FrameTimer.SetTargetFrameRate(FramesPerSecond);
+		
+	}
+	
+	/**
+	 * @brief Function to get stats over the recent frame times.
+	 * @return Returns a FrameTimeStats with times in milliseconds.
+	 */
+	FrameTimeStats GetFrameTimeStats() {
+		return FrameTimer.GetStats();
+		
+	}
+	
+	/**
+	 * @brief Function to get the frame timer.
+	 * @return Returns a pointer to the FrameTimerInstance of the window.
+	 */
+	FrameTimerInstance* GetFrameTimer() {
+		return &FrameTimer;
+		
 	}
 	
 	/**
@@ -113,9 +207,19 @@ public:
 		
 	}
 	
+	/**
+	 * @brief Function to check if the window was resized during the last FinishFrame().
+	 * @return Returns a bool of whether the framebuffer size changed.
+	 * @note Minimizing does not count as a resize, the last nonzero size is kept.
+	 */
+	bool WasResized() {
+		return Resized;
+		
+	}
+	
 	/**
 	 * @brief Function to get the width of the window.
-	 * @return Returns an int which is the width of the window.
+	 * @return Returns an int which is the width of the window's framebuffer in pixels.
 	 */
 	int GetWindowWidth() {
 		return Width;
@@ -123,7 +227,7 @@ public:
 	
 	/**
 	 * @brief Function to get the height of the window.
-	 * @return Returns an int which is the height of the window.
+	 * @return Returns an int which is the height of the window's framebuffer in pixels.
 	 */
 	int GetWindowHeight() {
 		return Height;
@@ -157,6 +261,9 @@ private:
 	const char* Title;			// Title of the window to be displayed
 	int Width;					// Width of the window in pixels
 	int Height;					// Height of the window in pixels
+	bool Resized = false;		// Whether the size changed during the last FinishFrame
+	int SwapInterval = 0;		// The swap interval that was last set, negative is adaptive
+	FrameTimerInstance FrameTimer;	// Frame limiter and frame time history
 	static int WindowCount;		// The count of windows across all instances of Windows.
 	
 };